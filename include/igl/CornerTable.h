@@ -0,0 +1,459 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_CORNERTABLE_H
+#define IGL_CORNERTABLE_H
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace igl
+{
+  // A persistent corner table [Rossignac 2001] for edge-manifold triangle
+  // meshes. Corner c = 3*f+i is the i-th corner of face f. All connectivity is
+  // stored in three flat arrays so that navigation is O(1) and local
+  // operations (flip, split, collapse) patch the arrays in place instead of
+  // rebuilding E, EMAP, EF, EI, TT, VF etc. globally.
+  //
+  // Removed faces and vertices are kept as tombstones (CV = -1, VC = -1) so
+  // that indices stay valid; new faces and vertices are appended. Use
+  // faces() to convert back to (V,F) form (with remove_unreferenced if
+  // desired).
+  //
+  // Example:
+  //   igl::CornerTable ct(F,V.rows());
+  //   // flip the edge across from the first corner of face 0
+  //   ct.flip(0);
+  //   // split and place the new vertex at the edge midpoint
+  //   const int a = ct.vertex(ct.next(0)), b = ct.vertex(ct.prev(0));
+  //   const int w = ct.split(0);
+  //   V.conservativeResize(w+1,V.cols());
+  //   V.row(w) = 0.5*(V.row(a)+V.row(b));
+  //   ct.faces(F);
+  class CornerTable
+  {
+    public:
+      // CV  #F*3 list of corner vertices (-1 for removed faces)
+      // CO  #F*3 list of opposite corners: CO[c] is the corner across the
+      //   edge opposite c (-1 on the boundary, on non-manifold edges and for
+      //   removed faces)
+      // VC  #V list of one corner incident on each vertex (-1 for removed or
+      //   unreferenced vertices)
+      std::vector<int> CV,CO,VC;
+    public:
+      inline CornerTable(){}
+      // Build from faces in O(#F + #V) using a counting sort of edges.
+      //
+      // Inputs:
+      //   F  #F by 3 list of triangle indices
+      //   n  number of vertices (e.g. V.rows())
+      template <typename DerivedF>
+      inline CornerTable(const Eigen::PlainObjectBase<DerivedF> & F, int n);
+      template <typename DerivedF>
+      inline void init(const Eigen::PlainObjectBase<DerivedF> & F, int n);
+      // Output the remaining faces.
+      //
+      // Outputs:
+      //   F  #F by 3 list of triangle indices into original vertex indices
+      //   J  #F list of indices into the internal faces
+      template <typename DerivedF>
+      inline void faces(Eigen::PlainObjectBase<DerivedF> & F) const;
+      template <typename DerivedF, typename DerivedJ>
+      inline void faces(
+        Eigen::PlainObjectBase<DerivedF> & F,
+        Eigen::PlainObjectBase<DerivedJ> & J) const;
+      // Navigation (all O(1))
+      inline int num_faces() const { return CV.size()/3; }
+      inline int num_vertices() const { return VC.size(); }
+      inline static int face(const int c){ return c/3; }
+      inline static int next(const int c){ return 3*(c/3)+(c+1)%3; }
+      inline static int prev(const int c){ return 3*(c/3)+(c+2)%3; }
+      inline int vertex(const int c) const { return CV[c]; }
+      inline int opposite(const int c) const { return CO[c]; }
+      inline bool is_removed_face(const int f) const { return CV[3*f] < 0; }
+      inline bool is_boundary(const int c) const { return CO[c] < 0; }
+      // Next corner around vertex(c) (crossing the edge from vertex(c) to
+      // vertex(prev(c))), -1 at the boundary
+      inline int swing(const int c) const;
+      // Previous corner around vertex(c), -1 at the boundary
+      inline int unswing(const int c) const;
+      // Circulate around a vertex: corners of v in swing order, starting at a
+      // boundary corner if v is on the boundary. Costs O(valence).
+      //
+      // Inputs:
+      //   v  vertex index
+      // Outputs:
+      //   C  list of corners incident on v
+      // Returns true if v is on the boundary
+      inline bool vertex_corners(const int v, std::vector<int> & C) const;
+      // Neighboring vertices of v in circulation order (see vertex_corners)
+      inline void vertex_vertices(const int v, std::vector<int> & N) const;
+      // Flip the (interior) edge opposite corner c. Faces (v,a,b),(d,b,a)
+      // become (v,a,d),(d,b,v). O(valence) for the validity check.
+      //
+      // Returns false (and does nothing) if the edge is on the boundary or the
+      // new edge (v,d) already exists
+      inline bool flip(const int c);
+      // Split the edge opposite corner c by inserting a new vertex w (appended
+      // to the vertex list). Face (v,a,b) becomes (v,a,w) and the new face
+      // (v,w,b) is appended; if the edge is interior, its other face (d,b,a)
+      // likewise becomes (d,b,w) and (d,w,a) is appended. O(1).
+      //
+      // Returns index of new vertex
+      inline int split(const int c);
+      // Collapse the edge opposite corner c, merging vertex(prev(c)) into
+      // vertex(next(c)). The (one or two) incident faces are removed.
+      // O(valence) for the link condition check and relabeling.
+      //
+      // Returns false (and does nothing) if the collapse would make the mesh
+      // non-manifold
+      inline bool collapse(const int c);
+    private:
+      // Neighboring vertices given the corners C of a vertex and whether it
+      // is on the boundary (see vertex_corners)
+      inline void corner_vertices(
+        const std::vector<int> & C,
+        const bool boundary,
+        std::vector<int> & N) const;
+  };
+}
+
+// Implementation
+
+template <typename DerivedF>
+inline igl::CornerTable::CornerTable(
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  int n)
+{
+  init(F,n);
+}
+
+template <typename DerivedF>
+inline void igl::CornerTable::init(
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  int n)
+{
+  assert(F.cols() == 3 && "F should contain triangles");
+  const int m = F.rows();
+  CV.resize(3*m);
+  CO.assign(3*m,-1);
+  VC.assign(n,-1);
+  for(int f = 0;f<m;f++)
+  {
+    for(int i = 0;i<3;i++)
+    {
+      CV[3*f+i] = F(f,i);
+      VC[F(f,i)] = 3*f+i;
+    }
+  }
+  // Bucket corners by the smaller vertex of their opposite edge
+  std::vector<int> offset(n+1,0);
+  for(int c = 0;c<3*m;c++)
+  {
+    offset[std::min(CV[next(c)],CV[prev(c)])+1]++;
+  }
+  for(int v = 0;v<n;v++)
+  {
+    offset[v+1] += offset[v];
+  }
+  std::vector<std::pair<int,int> > H(3*m);
+  {
+    std::vector<int> fill(offset.begin(),offset.end()-1);
+    for(int c = 0;c<3*m;c++)
+    {
+      const int a = CV[next(c)];
+      const int b = CV[prev(c)];
+      H[fill[std::min(a,b)]++] = std::make_pair(std::max(a,b),c);
+    }
+  }
+  for(int v = 0;v<n;v++)
+  {
+    std::sort(H.begin()+offset[v],H.begin()+offset[v+1]);
+    for(int j = offset[v];j<offset[v+1];)
+    {
+      int k = j+1;
+      while(k<offset[v+1] && H[k].first == H[j].first)
+      {
+        k++;
+      }
+      // Only manifold, consistently oriented edges are glued
+      if(k-j == 2 &&
+        CV[next(H[j].second)] == CV[prev(H[j+1].second)])
+      {
+        CO[H[j].second] = H[j+1].second;
+        CO[H[j+1].second] = H[j].second;
+      }
+      j = k;
+    }
+  }
+}
+
+template <typename DerivedF>
+inline void igl::CornerTable::faces(Eigen::PlainObjectBase<DerivedF> & F) const
+{
+  Eigen::VectorXi J;
+  faces(F,J);
+}
+
+template <typename DerivedF, typename DerivedJ>
+inline void igl::CornerTable::faces(
+  Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedJ> & J) const
+{
+  int m = 0;
+  for(int f = 0;f<num_faces();f++)
+  {
+    m += !is_removed_face(f);
+  }
+  F.resize(m,3);
+  J.resize(m,1);
+  int k = 0;
+  for(int f = 0;f<num_faces();f++)
+  {
+    if(!is_removed_face(f))
+    {
+      F.row(k) << CV[3*f+0],CV[3*f+1],CV[3*f+2];
+      J(k) = f;
+      k++;
+    }
+  }
+}
+
+inline int igl::CornerTable::swing(const int c) const
+{
+  const int o = CO[next(c)];
+  return o<0 ? -1 : next(o);
+}
+
+inline int igl::CornerTable::unswing(const int c) const
+{
+  const int o = CO[prev(c)];
+  return o<0 ? -1 : prev(o);
+}
+
+inline bool igl::CornerTable::vertex_corners(
+  const int v,
+  std::vector<int> & C) const
+{
+  C.clear();
+  const int c0 = VC[v];
+  if(c0 < 0)
+  {
+    return false;
+  }
+  // Rewind to the boundary (if any)
+  int s = c0;
+  bool boundary = false;
+  while(true)
+  {
+    const int u = unswing(s);
+    if(u < 0)
+    {
+      boundary = true;
+      break;
+    }
+    if(u == c0)
+    {
+      break;
+    }
+    s = u;
+  }
+  int c = s;
+  do
+  {
+    C.push_back(c);
+    c = swing(c);
+  }while(c >= 0 && c != s);
+  return boundary;
+}
+
+inline void igl::CornerTable::vertex_vertices(
+  const int v,
+  std::vector<int> & N) const
+{
+  std::vector<int> C;
+  const bool boundary = vertex_corners(v,C);
+  corner_vertices(C,boundary,N);
+}
+
+inline void igl::CornerTable::corner_vertices(
+  const std::vector<int> & C,
+  const bool boundary,
+  std::vector<int> & N) const
+{
+  N.clear();
+  if(boundary && !C.empty())
+  {
+    // across the boundary edge preceding the first corner
+    N.push_back(CV[next(C.front())]);
+  }
+  for(const int c : C)
+  {
+    N.push_back(CV[prev(c)]);
+  }
+}
+
+inline bool igl::CornerTable::flip(const int c)
+{
+  const int o = CO[c];
+  if(o < 0)
+  {
+    return false;
+  }
+  const int c1 = next(c), c2 = prev(c), o1 = next(o), o2 = prev(o);
+  const int v = CV[c], a = CV[c1], b = CV[c2], d = CV[o];
+  if(v == d)
+  {
+    return false;
+  }
+  // Refuse to create an existing edge
+  std::vector<int> N;
+  vertex_vertices(v,N);
+  if(std::find(N.begin(),N.end(),d) != N.end())
+  {
+    return false;
+  }
+  const int A = CO[o1], C = CO[c1];
+  // (v,a,b),(d,b,a) --> (v,a,d),(d,b,v)
+  CV[c2] = d;
+  CV[o2] = v;
+  CO[c] = A;
+  if(A >= 0) CO[A] = c;
+  CO[o] = C;
+  if(C >= 0) CO[C] = o;
+  CO[c1] = o1;
+  CO[o1] = c1;
+  VC[v] = c;
+  VC[a] = c1;
+  VC[b] = o1;
+  VC[d] = o;
+  return true;
+}
+
+inline int igl::CornerTable::split(const int c)
+{
+  const int o = CO[c];
+  const int c1 = next(c), c2 = prev(c);
+  const int v = CV[c], a = CV[c1], b = CV[c2];
+  const int w = VC.size();
+  VC.push_back(c2);
+  const int X = CO[c1];
+  // (v,a,b) --> (v,a,w),(v,w,b)
+  const int n0 = CV.size();
+  const int n1 = n0+1, n2 = n0+2;
+  CV.push_back(v);
+  CV.push_back(w);
+  CV.push_back(b);
+  CO.push_back(-1);
+  CO.push_back(X);
+  CO.push_back(c1);
+  if(X >= 0) CO[X] = n1;
+  CV[c2] = w;
+  CO[c1] = n2;
+  CO[c] = -1;
+  VC[v] = c;
+  VC[a] = c1;
+  VC[b] = n2;
+  if(o >= 0)
+  {
+    // (d,b,a) --> (d,b,w),(d,w,a)
+    const int o1 = next(o), o2 = prev(o);
+    const int d = CV[o];
+    const int Y = CO[o1];
+    const int m0 = CV.size();
+    const int m1 = m0+1, m2 = m0+2;
+    CV.push_back(d);
+    CV.push_back(w);
+    CV.push_back(a);
+    CO.push_back(c);
+    CO.push_back(Y);
+    CO.push_back(o1);
+    if(Y >= 0) CO[Y] = m1;
+    CV[o2] = w;
+    CO[o1] = m2;
+    CO[c] = m0;
+    CO[o] = n0;
+    CO[n0] = o;
+    VC[d] = o;
+  }
+  return w;
+}
+
+inline bool igl::CornerTable::collapse(const int c)
+{
+  const int o = CO[c];
+  const int c1 = next(c), c2 = prev(c);
+  const int a = CV[c1], b = CV[c2];
+  if(a == b)
+  {
+    return false;
+  }
+  // Link condition: common neighbors of a and b must be exactly the apexes of
+  // the removed faces
+  std::vector<int> Na,Nb,Ca,Cb;
+  const bool a_boundary = vertex_corners(a,Ca);
+  corner_vertices(Ca,a_boundary,Na);
+  const bool b_boundary = vertex_corners(b,Cb);
+  corner_vertices(Cb,b_boundary,Nb);
+  if(o >= 0 && a_boundary && b_boundary)
+  {
+    // Interior edge between two boundary vertices would pinch the mesh
+    return false;
+  }
+  std::sort(Na.begin(),Na.end());
+  std::sort(Nb.begin(),Nb.end());
+  std::vector<int> common;
+  std::set_intersection(
+    Na.begin(),Na.end(),Nb.begin(),Nb.end(),std::back_inserter(common));
+  const int apexes = o>=0 ? 2 : 1;
+  if((int)common.size() != apexes)
+  {
+    return false;
+  }
+  // Relabel b's corners as a
+  for(const int cb : Cb)
+  {
+    CV[cb] = a;
+  }
+  // Glue the neighbors across each removed face and fix the vertex corners
+  const auto remove_face = [this,a](const int r)
+  {
+    const int r1 = next(r), r2 = prev(r);
+    const int P = CO[r1], Q = CO[r2];
+    if(P >= 0) CO[P] = Q;
+    if(Q >= 0) CO[Q] = P;
+    const int apex = CV[r];
+    // Surviving corners at apex and at a next to the glued edges
+    const int cands[4] = {P>=0?next(P):-1, P>=0?prev(P):-1,
+      Q>=0?next(Q):-1, Q>=0?prev(Q):-1};
+    VC[apex] = -1;
+    for(const int k : cands)
+    {
+      if(k >= 0 && CV[k] == apex) VC[apex] = k;
+      if(k >= 0 && CV[k] == a) VC[a] = k;
+    }
+    for(int i = 0;i<3;i++)
+    {
+      CV[3*face(r)+i] = -1;
+      CO[3*face(r)+i] = -1;
+    }
+  };
+  VC[a] = -1;
+  remove_face(c);
+  if(o >= 0)
+  {
+    remove_face(o);
+  }
+  VC[b] = -1;
+  return true;
+}
+
+#endif
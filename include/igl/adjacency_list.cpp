@@ -9,6 +9,7 @@
 
 #include "verbose.h"
 #include <algorithm>
+#include <atomic>
 
 template <typename Index, typename IndexVector>
 IGL_INLINE void igl::adjacency_list(
@@ -127,6 +128,84 @@ IGL_INLINE void igl::adjacency_list(
   }
 }
 
+template <typename DerivedF, typename DerivedA, typename DerivedAI>
+IGL_INLINE void igl::adjacency_list(
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedA> & A,
+  Eigen::PlainObjectBase<DerivedAI> & AI)
+{
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  typedef typename DerivedF::Index Index;
+  typedef typename DerivedA::Scalar AScalar;
+  typedef typename DerivedAI::Scalar AIScalar;
+  const Index m = F.rows();
+  const Index ss = F.cols();
+  const Index n = F.size() == 0 ? 0 : F.maxCoeff()+1;
+  // Counting sort both directions of every face edge by source vertex.
+  // Counts and slots are claimed atomically so faces are processed in
+  // parallel; the order within each vertex's range does not matter since it
+  // is sorted below.
+  std::vector<std::atomic<AIScalar> > next(n);
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(Index v = 0;v<n;v++)
+  {
+    next[v].store(0,std::memory_order_relaxed);
+  }
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(Index i = 0;i<m;i++)
+  {
+    for(Index j = 0;j<ss;j++)
+    {
+      next[F(i,j)].fetch_add(1,std::memory_order_relaxed);
+      next[F(i,(j+1)%ss)].fetch_add(1,std::memory_order_relaxed);
+    }
+  }
+  std::vector<AIScalar> offset(n+1,0);
+  for(Index v = 0;v<n;v++)
+  {
+    offset[v+1] = offset[v] + next[v].load(std::memory_order_relaxed);
+    next[v].store(offset[v],std::memory_order_relaxed);
+  }
+  std::vector<AScalar> D(offset[n]);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(Index i = 0;i<m;i++)
+  {
+    for(Index j = 0;j<ss;j++)
+    {
+      const AScalar s = F(i,j);
+      const AScalar d = F(i,(j+1)%ss);
+      D[next[s].fetch_add(1,std::memory_order_relaxed)] = d;
+      D[next[d].fetch_add(1,std::memory_order_relaxed)] = s;
+    }
+  }
+  // Remove duplicates within each vertex's range
+  AI.resize(n+1,1);
+  AI(0) = 0;
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(Index v = 0;v<n;v++)
+  {
+    std::sort(D.begin()+offset[v],D.begin()+offset[v+1]);
+    AI(v+1) =
+      std::unique(D.begin()+offset[v],D.begin()+offset[v+1]) -
+      (D.begin()+offset[v]);
+  }
+  for(Index v = 0;v<n;v++)
+  {
+    AI(v+1) += AI(v);
+  }
+  A.resize(AI(n),1);
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(Index v = 0;v<n;v++)
+  {
+    std::copy(
+      D.begin()+offset[v],
+      D.begin()+offset[v]+(AI(v+1)-AI(v)),
+      A.data()+AI(v));
+  }
+}
+
 template <typename Index>
 IGL_INLINE void igl::adjacency_list(
   const std::vector<std::vector<Index> > & F,
@@ -163,4 +242,6 @@ IGL_INLINE void igl::adjacency_list(
 // generated by autoexplicit.sh
 template void igl::adjacency_list<Eigen::Matrix<int, -1, -1, 0, -1, -1>, int>(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >&, bool);
 template void igl::adjacency_list<Eigen::Matrix<int, -1, 3, 0, -1, 3>, int>(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >&, bool);
+template void igl::adjacency_list<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::adjacency_list<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<long, -1, 1, 0, -1, 1>, Eigen::Matrix<long, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 1, 0, -1, 1> >&);
 #endif
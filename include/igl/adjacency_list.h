@@ -35,6 +35,24 @@ namespace igl
     std::vector<std::vector<IndexVector> >& A,
     bool sorted = false);
 
+  // Compressed (CSR) variant storing all neighbors in flat arrays rather than
+  // one heap allocated list per vertex. Neighbors are in increasing order.
+  //
+  // Inputs:
+  //   F  #F by dim list of mesh faces
+  // Outputs:
+  //   A  #A list of adjacent vertices so that A(AI(i)) ... A(AI(i+1)-1) are
+  //     the neighbors of vertex i
+  //   AI  #V+1 list of offsets into A (#V = F.maxCoeff()+1)
+  //
+  // The scalar types of A and AI set the index width, e.g. use 64 bit AI when
+  // the number of incidences exceeds 2^31. Faces are scattered in parallel.
+  template <typename DerivedF, typename DerivedA, typename DerivedAI>
+  IGL_INLINE void adjacency_list(
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedA> & A,
+    Eigen::PlainObjectBase<DerivedAI> & AI);
+
   // Variant that accepts polygonal faces. 
   // Each element of F is a set of indices of a polygonal face.
   template <typename Index>
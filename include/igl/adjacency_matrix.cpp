@@ -7,8 +7,10 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "adjacency_matrix.h"
 
+#include "adjacency_list.h"
 #include "verbose.h"
 
+#include <algorithm>
 #include <vector>
 
 template <typename T>
@@ -16,50 +18,33 @@ IGL_INLINE void igl::adjacency_matrix(
   const Eigen::MatrixXi & F, 
   Eigen::SparseMatrix<T>& A)
 {
-  using namespace std;
-  using namespace Eigen;
-
-  typedef Triplet<T> IJV;
-  vector<IJV > ijv;
-  ijv.reserve(F.size()*2);
-  // Loop over faces
-  for(int i = 0;i<F.rows();i++)
-  {
-    // Loop over this face
-    for(int j = 0;j<F.cols();j++)
-    {
-      // Get indices of edge: s --> d
-      int s = F(i,j);
-      int d = F(i,(j+1)%F.cols());
-      ijv.push_back(IJV(s,d,1));
-      ijv.push_back(IJV(d,s,1));
-    }
-  }
+  return adjacency_matrix(
+    static_cast<const Eigen::PlainObjectBase<Eigen::MatrixXi> &>(F),A);
+}
 
-  const int n = F.maxCoeff()+1;
+template <typename DerivedF, typename T, int Options, typename StorageIndex>
+IGL_INLINE void igl::adjacency_matrix(
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::SparseMatrix<T,Options,StorageIndex>& A)
+{
+  using namespace Eigen;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  // A is symmetric so its row and column major patterns are both the
+  // neighbors of each vertex in increasing order
+  Matrix<StorageIndex,Dynamic,1> N,NI;
+  adjacency_list(F,N,NI);
+  const StorageIndex n = NI.size()-1;
+  const StorageIndex nnz = NI(n);
   A.resize(n,n);
-  switch(F.cols())
-  {
-    case 3:
-      A.reserve(6*(F.maxCoeff()+1));
-      break;
-    case 4:
-      A.reserve(26*(F.maxCoeff()+1));
-      break;
-  }
-  A.setFromTriplets(ijv.begin(),ijv.end());
-
-  // Force all non-zeros to be one
-
-  // Iterate over outside
-  for(int k=0; k<A.outerSize(); ++k)
+  A.resizeNonZeros(nnz);
+  std::copy(NI.data(),NI.data()+n+1,A.outerIndexPtr());
+#pragma omp parallel for if (nnz>IGL_OMP_MIN_VALUE)
+  for(StorageIndex k = 0;k<nnz;k++)
   {
-    // Iterate over inside
-    for(typename Eigen::SparseMatrix<T>::InnerIterator it (A,k); it; ++it)
-    {
-      assert(it.value() != 0);
-      A.coeffRef(it.row(),it.col()) = 1;
-    }
+    A.innerIndexPtr()[k] = N(k);
+    A.valuePtr()[k] = 1;
   }
 }
 
@@ -67,4 +52,7 @@ IGL_INLINE void igl::adjacency_matrix(
 // Explicit template specialization
 template void igl::adjacency_matrix<int>(Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::SparseMatrix<int, 0, int>&);
 template void igl::adjacency_matrix<double>(Eigen::Matrix<int, -1, -1, 0, -1, -1> const&, Eigen::SparseMatrix<double, 0, int>&);
+template void igl::adjacency_matrix<Eigen::Matrix<int, -1, -1, 0, -1, -1>, int, 0, int>(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::SparseMatrix<int, 0, int>&);
+template void igl::adjacency_matrix<Eigen::Matrix<int, -1, -1, 0, -1, -1>, double, 0, int>(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::SparseMatrix<double, 0, int>&);
+template void igl::adjacency_matrix<Eigen::Matrix<int, -1, -1, 0, -1, -1>, bool, 0, long>(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::SparseMatrix<bool, 0, long>&);
 #endif
@@ -42,6 +42,14 @@ namespace igl
   IGL_INLINE void adjacency_matrix(
     const Eigen::MatrixXi & F, 
     Eigen::SparseMatrix<T>& A);
+  // Templated variant for any face index type and sparse index width (e.g.
+  // Eigen::SparseMatrix<bool,Eigen::ColMajor,long>, since only the pattern
+  // matters). The compressed storage of A is filled directly from the
+  // compressed adjacency_list (built in parallel), without triplets.
+  template <typename DerivedF, typename T, int Options, typename StorageIndex>
+  IGL_INLINE void adjacency_matrix(
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::SparseMatrix<T,Options,StorageIndex>& A);
 }
 
 #ifndef IGL_STATIC_LIBRARY
@@ -0,0 +1,303 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "algebraic_multigrid.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+template <typename T>
+IGL_INLINE bool igl::algebraic_multigrid_precompute(
+  const Eigen::SparseMatrix<T> & A,
+  algebraic_multigrid_data<T> & data)
+{
+  using namespace Eigen;
+  using namespace std;
+  typedef Matrix<T,Dynamic,1> VectorXT;
+  assert(A.rows() == A.cols() && "A should be square");
+  data.A.clear();
+  data.P.clear();
+  data.PT.clear();
+  data.wDinv.clear();
+  data.A.push_back(A);
+  while(
+    data.A.back().rows() > data.coarsest &&
+    (int)data.A.size() < data.max_levels)
+  {
+    const SparseMatrix<T> & Al = data.A.back();
+    const int n = Al.rows();
+    const VectorXT D = Al.diagonal();
+    // Gershgorin bound on spectral radius of inv(D)*A determines damping of
+    // both the smoother and the prolongation smoother
+    T rho = 0;
+    for(int i = 0;i<n;i++)
+    {
+      if(D(i) <= 0)
+      {
+        cerr<<"Error: algebraic_multigrid_precompute: A should be positive "
+          "definite"<<endl;
+        return false;
+      }
+      T row = 0;
+      for(typename SparseMatrix<T>::InnerIterator it(Al,i);it;++it)
+      {
+        row += std::abs(it.value());
+      }
+      rho = std::max(rho,row/D(i));
+    }
+    const T omega = T(4)/(T(3)*rho);
+    data.wDinv.push_back((omega*D.array().inverse()).matrix());
+
+    // Aggregate strongly connected unknowns (A is symmetric so column i
+    // holds the neighbors of i)
+    const auto strong = [&](const int i, const int j, const T v)->bool
+    {
+      return i != j && std::abs(v) > data.strength*std::sqrt(D(i)*D(j));
+    };
+    vector<int> agg(n,-1);
+    int na = 0;
+    for(int i = 0;i<n;i++)
+    {
+      if(agg[i] >= 0)
+      {
+        continue;
+      }
+      bool free_nbhd = true;
+      for(typename SparseMatrix<T>::InnerIterator it(Al,i);it;++it)
+      {
+        if(strong(i,it.row(),it.value()) && agg[it.row()] >= 0)
+        {
+          free_nbhd = false;
+          break;
+        }
+      }
+      if(free_nbhd)
+      {
+        agg[i] = na;
+        for(typename SparseMatrix<T>::InnerIterator it(Al,i);it;++it)
+        {
+          if(strong(i,it.row(),it.value()))
+          {
+            agg[it.row()] = na;
+          }
+        }
+        na++;
+      }
+    }
+    // Attach leftovers to a neighboring root aggregate
+    const vector<int> root_agg = agg;
+    for(int i = 0;i<n;i++)
+    {
+      if(agg[i] >= 0)
+      {
+        continue;
+      }
+      for(typename SparseMatrix<T>::InnerIterator it(Al,i);it;++it)
+      {
+        if(strong(i,it.row(),it.value()) && root_agg[it.row()] >= 0)
+        {
+          agg[i] = root_agg[it.row()];
+          break;
+        }
+      }
+    }
+    // Anything left forms new aggregates with its free neighbors
+    for(int i = 0;i<n;i++)
+    {
+      if(agg[i] >= 0)
+      {
+        continue;
+      }
+      agg[i] = na;
+      for(typename SparseMatrix<T>::InnerIterator it(Al,i);it;++it)
+      {
+        if(strong(i,it.row(),it.value()) && agg[it.row()] < 0)
+        {
+          agg[it.row()] = na;
+        }
+      }
+      na++;
+    }
+    if(na == n)
+    {
+      // No coarsening possible (e.g. no strong connections)
+      break;
+    }
+
+    // Tentative piecewise constant prolongation smoothed by one damped
+    // Jacobi step: P = (I - omega*inv(D)*A)*P0
+    vector<Triplet<T> > ijv;
+    ijv.reserve(n);
+    for(int i = 0;i<n;i++)
+    {
+      ijv.push_back(Triplet<T>(i,agg[i],1));
+    }
+    SparseMatrix<T> P0(n,na);
+    P0.setFromTriplets(ijv.begin(),ijv.end());
+    // Scale entries in place rather than forming a diagonal product (the
+    // diagonal of A is structurally present since A is positive definite)
+    SparseMatrix<T> S = Al;
+    for(int j = 0;j<n;j++)
+    {
+      for(typename SparseMatrix<T>::InnerIterator it(S,j);it;++it)
+      {
+        it.valueRef() *= -data.wDinv.back()(it.row());
+        if(it.row() == j)
+        {
+          it.valueRef() += 1;
+        }
+      }
+    }
+    SparseMatrix<T> P = S*P0;
+    SparseMatrix<T> PT = P.transpose();
+    // Galerkin coarse operator
+    SparseMatrix<T> Ac = PT*(Al*P);
+    data.P.push_back(P);
+    data.PT.push_back(PT);
+    data.A.push_back(Ac);
+  }
+  data.coarse.compute(data.A.back());
+  switch(data.coarse.info())
+  {
+    case Eigen::Success:
+      break;
+    case Eigen::NumericalIssue:
+      cerr<<"Error: Numerical issue."<<endl;
+      return false;
+    default:
+      cerr<<"Error: Other."<<endl;
+      return false;
+  }
+  return true;
+}
+
+template <typename T>
+IGL_INLINE bool igl::algebraic_multigrid_solve(
+  const algebraic_multigrid_data<T> & data,
+  const Eigen::Matrix<T,Eigen::Dynamic,1> & b,
+  Eigen::Matrix<T,Eigen::Dynamic,1> & x)
+{
+  using namespace Eigen;
+  using namespace std;
+  typedef Matrix<T,Dynamic,1> VectorXT;
+  typedef SparseMatrix<T> SparseMatrixT;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  assert(data.A.size() > 0 && "Call algebraic_multigrid_precompute first");
+  const int n = data.A[0].rows();
+  assert(b.size() == n);
+  // y = M'*v, one independent dot product per column of M. With M = A (and
+  // A symmetric) this is A*v, with M = PT it is P*v.
+  const auto transpose_times = [](
+    const SparseMatrixT & M,
+    const VectorXT & v,
+    VectorXT & y)
+  {
+    const int m = M.cols();
+    y.resize(m);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+    for(int j = 0;j<m;j++)
+    {
+      T yj = 0;
+      for(typename SparseMatrixT::InnerIterator it(M,j);it;++it)
+      {
+        yj += it.value()*v(it.row());
+      }
+      y(j) = yj;
+    }
+  };
+  // Damped Jacobi sweep x += wDinv .* (b - A x), using t as scratch
+  const auto smooth = [&data,&transpose_times](
+    const int l,
+    const VectorXT & bl,
+    VectorXT & xl,
+    VectorXT & t)
+  {
+    transpose_times(data.A[l],xl,t);
+    const int m = xl.size();
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+    for(int i = 0;i<m;i++)
+    {
+      xl(i) += data.wDinv[l](i)*(bl(i)-t(i));
+    }
+  };
+  // Per-call workspace so that concurrent solves do not share state
+  const int L = data.A.size();
+  vector<VectorXT> bl(L),xl(L),tl(L);
+  // Symmetric V-cycle approximating z = inv(A)*r
+  const auto vcycle = [&](const VectorXT & r, VectorXT & z)
+  {
+    bl[0] = r;
+    for(int l = 0;l<L-1;l++)
+    {
+      xl[l] = data.wDinv[l].cwiseProduct(bl[l]);
+      for(int s = 1;s<data.smooth_iters;s++)
+      {
+        smooth(l,bl[l],xl[l],tl[l]);
+      }
+      transpose_times(data.A[l],xl[l],tl[l]);
+      tl[l] = bl[l] - tl[l];
+      transpose_times(data.P[l],tl[l],bl[l+1]);
+    }
+    xl[L-1] = data.coarse.solve(bl[L-1]);
+    for(int l = L-2;l>=0;l--)
+    {
+      transpose_times(data.PT[l],xl[l+1],tl[l]);
+      xl[l] += tl[l];
+      for(int s = 0;s<data.smooth_iters;s++)
+      {
+        smooth(l,bl[l],xl[l],tl[l]);
+      }
+    }
+    z = xl[0];
+  };
+
+  if(x.size() != n)
+  {
+    x = VectorXT::Zero(n);
+  }
+  const T bnorm = b.norm();
+  if(bnorm == 0)
+  {
+    x.setZero();
+    return true;
+  }
+  VectorXT r,z,p,Ap;
+  transpose_times(data.A[0],x,Ap);
+  r = b - Ap;
+  if(r.norm() <= data.tol*bnorm)
+  {
+    return true;
+  }
+  vcycle(r,z);
+  p = z;
+  T rz = r.dot(z);
+  for(int iter = 0;iter<data.max_iter;iter++)
+  {
+    transpose_times(data.A[0],p,Ap);
+    const T alpha = rz/p.dot(Ap);
+    x += alpha*p;
+    r -= alpha*Ap;
+    if(r.norm() <= data.tol*bnorm)
+    {
+      return true;
+    }
+    vcycle(r,z);
+    const T rz_new = r.dot(z);
+    p = z + (rz_new/rz)*p;
+    rz = rz_new;
+  }
+  return false;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template bool igl::algebraic_multigrid_precompute<double>(Eigen::SparseMatrix<double, 0, int> const&, igl::algebraic_multigrid_data<double>&);
+template bool igl::algebraic_multigrid_solve<double>(igl::algebraic_multigrid_data<double> const&, Eigen::Matrix<double, -1, 1, 0, -1, 1> const&, Eigen::Matrix<double, -1, 1, 0, -1, 1>&);
+#endif
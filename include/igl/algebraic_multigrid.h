@@ -0,0 +1,100 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_ALGEBRAIC_MULTIGRID_H
+#define IGL_ALGEBRAIC_MULTIGRID_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <vector>
+
+namespace igl
+{
+  template <typename T>
+  struct algebraic_multigrid_data;
+  // ALGEBRAIC_MULTIGRID_PRECOMPUTE Build a smoothed aggregation multigrid
+  // hierarchy [Vanek et al. 1996] for a symmetric positive definite matrix
+  // (e.g. a cotangent Laplacian with Dirichlet boundary conditions). Coarse
+  // levels are Galerkin products P'*A*P so that memory grows linearly with
+  // the number of unknowns for mesh-based operators.
+  //
+  // Templates:
+  //   T  should be a eigen matrix primitive type like float or double
+  // Inputs:
+  //   A  n by n symmetric positive definite matrix
+  //   data  parameters (see algebraic_multigrid_data)
+  // Outputs:
+  //   data  multigrid hierarchy
+  // Returns true on success, false on error
+  //
+  template <typename T>
+  IGL_INLINE bool algebraic_multigrid_precompute(
+    const Eigen::SparseMatrix<T> & A,
+    algebraic_multigrid_data<T> & data);
+  // ALGEBRAIC_MULTIGRID_SOLVE Solve A*x = b using conjugate gradients
+  // preconditioned by a multigrid V-cycle with damped Jacobi smoothing. All
+  // matrix-vector products and smoothing sweeps run in parallel. Safe to call
+  // concurrently on the same data.
+  //
+  // Inputs:
+  //   data  multigrid hierarchy output from algebraic_multigrid_precompute
+  //   b  n by 1 right-hand side
+  //   x  n by 1 initial guess (ignored if not n by 1)
+  // Outputs:
+  //   x  n by 1 solution
+  // Returns true if the relative residual reached data.tol
+  //
+  template <typename T>
+  IGL_INLINE bool algebraic_multigrid_solve(
+    const algebraic_multigrid_data<T> & data,
+    const Eigen::Matrix<T,Eigen::Dynamic,1> & b,
+    Eigen::Matrix<T,Eigen::Dynamic,1> & x);
+}
+
+template <typename T>
+struct igl::algebraic_multigrid_data
+{
+  typedef Eigen::SparseMatrix<T> SparseMatrixT;
+  typedef Eigen::Matrix<T,Eigen::Dynamic,1> VectorXT;
+  // Parameters (set before calling algebraic_multigrid_precompute):
+  //   strength  threshold on |a_ij|/sqrt(a_ii*a_jj) for strong connections
+  //   coarsest  maximum number of unknowns of the coarsest level (which is
+  //     factored directly)
+  //   max_levels  maximum number of levels
+  //   smooth_iters  number of pre- and post-smoothing sweeps
+  //   tol  relative residual tolerance of conjugate gradients
+  //   max_iter  maximum number of conjugate gradient iterations
+  T strength;
+  int coarsest;
+  int max_levels;
+  int smooth_iters;
+  T tol;
+  int max_iter;
+  // A[l]  matrix at level l (A[0] is the input)
+  // P[l]  prolongation from level l+1 to level l
+  // PT[l]  restriction (transpose of P[l])
+  // wDinv[l]  damped inverse diagonal of A[l] (Jacobi smoother)
+  std::vector<SparseMatrixT> A,P,PT;
+  std::vector<VectorXT> wDinv;
+  // Factorization of the coarsest level
+  Eigen::SimplicialLDLT<SparseMatrixT> coarse;
+  algebraic_multigrid_data():
+    strength(0.08),
+    coarsest(500),
+    max_levels(20),
+    smooth_iters(2),
+    tol(1e-10),
+    max_iter(1000),
+    A(),P(),PT(),wDinv(),coarse()
+  {}
+};
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "algebraic_multigrid.cpp"
+#endif
+
+#endif
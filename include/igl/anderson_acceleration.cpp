@@ -0,0 +1,83 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "anderson_acceleration.h"
+#include <Eigen/QR>
+#include <algorithm>
+#include <cassert>
+
+template <typename T>
+IGL_INLINE void igl::anderson_acceleration_precompute(
+  const int n,
+  const int m,
+  anderson_acceleration_data<T> & data)
+{
+  assert(m >= 1 && "need at least one previous iterate");
+  data.m = m;
+  data.DG.resize(n,m);
+  data.DF.resize(n,m);
+  data.N.resize(m,m);
+  data.g_prev.resize(n);
+  data.f_prev.resize(n);
+  data.f.resize(n);
+  anderson_acceleration_reset(data);
+}
+
+template <typename T>
+IGL_INLINE void igl::anderson_acceleration_reset(
+  anderson_acceleration_data<T> & data)
+{
+  data.k = 0;
+}
+
+template <typename T>
+IGL_INLINE void igl::anderson_acceleration_solve(
+  anderson_acceleration_data<T> & data,
+  const Eigen::Matrix<T,Eigen::Dynamic,1> & g,
+  Eigen::Matrix<T,Eigen::Dynamic,1> & x)
+{
+  assert(g.size() == data.DG.rows());
+  assert(x.size() == g.size());
+  data.f = g - x;
+  if(data.k == 0)
+  {
+    // Nothing to combine with: plain fixed-point step
+    x = g;
+  }else
+  {
+    // Column of oldest difference (ring buffer: order does not matter to the
+    // least squares problem)
+    const int c = (data.k-1) % data.m;
+    const int mk = std::min(data.k,data.m);
+    data.DF.col(c) = data.f - data.f_prev;
+    data.DG.col(c) = g - data.g_prev;
+    for(int j = 0;j<mk;j++)
+    {
+      data.N(c,j) = data.DF.col(c).dot(data.DF.col(j));
+      data.N(j,c) = data.N(c,j);
+    }
+    data.rhs.noalias() = data.DF.leftCols(mk).transpose() * data.f;
+    // Small (mk by mk) and possibly rank deficient
+    data.theta = data.N.topLeftCorner(mk,mk).colPivHouseholderQr().solve(
+      data.rhs);
+    x = g;
+    x.noalias() -= data.DG.leftCols(mk) * data.theta;
+  }
+  data.g_prev = g;
+  data.f_prev = data.f;
+  data.k++;
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template void igl::anderson_acceleration_precompute<double>(int, int, igl::anderson_acceleration_data<double>&);
+template void igl::anderson_acceleration_precompute<float>(int, int, igl::anderson_acceleration_data<float>&);
+template void igl::anderson_acceleration_reset<double>(igl::anderson_acceleration_data<double>&);
+template void igl::anderson_acceleration_reset<float>(igl::anderson_acceleration_data<float>&);
+template void igl::anderson_acceleration_solve<double>(igl::anderson_acceleration_data<double>&, Eigen::Matrix<double, -1, 1, 0, -1, 1> const&, Eigen::Matrix<double, -1, 1, 0, -1, 1>&);
+template void igl::anderson_acceleration_solve<float>(igl::anderson_acceleration_data<float>&, Eigen::Matrix<float, -1, 1, 0, -1, 1> const&, Eigen::Matrix<float, -1, 1, 0, -1, 1>&);
+#endif
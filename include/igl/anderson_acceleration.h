@@ -0,0 +1,89 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_ANDERSON_ACCELERATION_H
+#define IGL_ANDERSON_ACCELERATION_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+
+namespace igl
+{
+  template <typename T>
+  struct anderson_acceleration_data;
+  // ANDERSON_ACCELERATION_PRECOMPUTE Prepare a history buffer for accelerating
+  // a fixed-point iteration x <-- G(x) (e.g. alternating local/global steps)
+  // using Anderson acceleration [Walker & Ni 2011, Peng et al. 2018]
+  //
+  // Templates:
+  //   T  should be a eigen matrix primitive type like float or double
+  // Inputs:
+  //   n  number of variables
+  //   m  number of previous iterates to remember
+  // Outputs:
+  //   data  history buffer
+  //
+  template <typename T>
+  IGL_INLINE void anderson_acceleration_precompute(
+    const int n,
+    const int m,
+    anderson_acceleration_data<T> & data);
+  // Forget all previous iterates (e.g. after a safeguard rejected an
+  // accelerated iterate). The buffers are kept.
+  //
+  // Inputs:
+  //   data  history buffer
+  // Outputs:
+  //   data  history buffer with no previous iterates
+  template <typename T>
+  IGL_INLINE void anderson_acceleration_reset(
+    anderson_acceleration_data<T> & data);
+  // ANDERSON_ACCELERATION_SOLVE Given the current iterate x and its image
+  // under the fixed-point map G(x), determine the next (accelerated) iterate
+  // as the affine combination of previous images minimizing the residual
+  // G(x)-x. Because the combination is affine, linear equality constraints
+  // satisfied by every image are satisfied by the result.
+  //
+  // Inputs:
+  //   data  history buffer
+  //   g  n-long image G(x) of the current iterate
+  //   x  n-long current iterate
+  // Outputs:
+  //   data  history buffer updated with (x,g)
+  //   x  n-long next iterate (no allocation if already sized)
+  //
+  template <typename T>
+  IGL_INLINE void anderson_acceleration_solve(
+    anderson_acceleration_data<T> & data,
+    const Eigen::Matrix<T,Eigen::Dynamic,1> & g,
+    Eigen::Matrix<T,Eigen::Dynamic,1> & x);
+}
+
+template <typename T>
+struct igl::anderson_acceleration_data
+{
+  typedef Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> MatrixXT;
+  typedef Eigen::Matrix<T,Eigen::Dynamic,1> VectorXT;
+  // Number of previous iterates to remember
+  int m;
+  // Number of updates since last reset
+  int k;
+  // n by m ring buffers of differences of successive images and residuals
+  MatrixXT DG,DF;
+  // m by m Gram matrix of DF
+  MatrixXT N;
+  // Previous image and residual
+  VectorXT g_prev,f_prev;
+  // Workspace: current residual, least squares rhs and coefficients
+  VectorXT f,rhs,theta;
+  anderson_acceleration_data():m(0),k(0){}
+};
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "anderson_acceleration.cpp"
+#endif
+
+#endif
@@ -0,0 +1,449 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "mesh_boolean_local.h"
+#include "mesh_boolean.h"
+#include <igl/AABB.h>
+#include <igl/facet_components.h>
+#include <igl/remove_unreferenced.h>
+#include <igl/unique_edge_map.h>
+#include <igl/winding_number.h>
+#include <igl/cgal/remesh_self_intersections.h>
+#include <cmath>
+#include <vector>
+
+#include <CGAL/Exact_predicates_exact_constructions_kernel.h>
+
+//#define IGL_MESH_BOOLEAN_LOCAL_DEBUG
+
+// Whether box overlaps the bounding box of some element in tree
+template <typename DerivedV>
+static bool mesh_boolean_local_overlaps(
+  const igl::AABB<DerivedV,3> & tree,
+  const Eigen::AlignedBox<double,3> & box)
+{
+  if(!tree.m_box.intersects(box))
+  {
+    return false;
+  }
+  if(tree.is_leaf())
+  {
+    return true;
+  }
+  return
+    mesh_boolean_local_overlaps(*tree.m_left,box) ||
+    mesh_boolean_local_overlaps(*tree.m_right,box);
+}
+
+template <
+  typename DerivedVA,
+  typename DerivedFA,
+  typename DerivedVB,
+  typename DerivedFB,
+  typename DerivedVC,
+  typename DerivedFC,
+  typename DerivedJ>
+IGL_INLINE void igl::mesh_boolean_local(
+  const Eigen::PlainObjectBase<DerivedVA > & VA,
+  const Eigen::PlainObjectBase<DerivedFA > & FA,
+  const Eigen::PlainObjectBase<DerivedVB > & VB,
+  const Eigen::PlainObjectBase<DerivedFB > & FB,
+  const MeshBooleanType & type,
+  Eigen::PlainObjectBase<DerivedVC > & VC,
+  Eigen::PlainObjectBase<DerivedFC > & FC,
+  Eigen::PlainObjectBase<DerivedJ > & J)
+{
+  using namespace Eigen;
+  using namespace std;
+  using namespace igl;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  typedef CGAL::Exact_predicates_exact_constructions_kernel Kernel;
+  typedef Kernel::FT ExactScalar;
+  typedef typename DerivedVC::Scalar Scalar;
+  typedef typename DerivedFC::Scalar Index;
+  typedef Matrix<Scalar,Dynamic,3> MatrixX3S;
+  typedef Matrix<ExactScalar,Dynamic,3> MatrixX3ES;
+  typedef Matrix<Index,Dynamic,3> MatrixX3I;
+  typedef Matrix<Index,Dynamic,2> MatrixX2I;
+  typedef Matrix<Index,Dynamic,1> VectorXI;
+  typedef Matrix<typename DerivedJ::Scalar,Dynamic,1> VectorXJ;
+#ifdef IGL_MESH_BOOLEAN_LOCAL_DEBUG
+  cout<<"mesh boolean local..."<<endl;
+#endif
+  // Mesh k is A (k=0) or B (k=1), its facets and vertices are offset by those
+  // of A in [FA;FB] and [VA;VB]
+  const MatrixXd Vk[2] = {VA.template cast<double>(),VB.template cast<double>()};
+  const MatrixXi Fk[2] = {FA.template cast<int>(),FB.template cast<int>()};
+  const Index voff[2] = {0,(Index)VA.rows()};
+  const Index foff[2] = {0,(Index)FA.rows()};
+  const Index nv = VA.rows()+VB.rows();
+
+#ifdef IGL_MESH_BOOLEAN_LOCAL_DEBUG
+  cout<<"find local facets..."<<endl;
+#endif
+  // Facets of each mesh whose bounding box overlaps that of a facet of the
+  // other. Any facet touching the intersection is among them.
+  vector<char> local[2];
+  for(int k = 0;k<2;k++)
+  {
+    const int o = 1-k;
+    local[k].assign(Fk[k].rows(),0);
+    if(Fk[o].rows() == 0)
+    {
+      continue;
+    }
+    AABB<MatrixXd,3> tree;
+    tree.init(Vk[o],Fk[o]);
+    const int m = Fk[k].rows();
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+    for(int f = 0;f<m;f++)
+    {
+      AlignedBox<double,3> box;
+      for(int c = 0;c<3;c++)
+      {
+        box.extend(Vk[k].row(Fk[k](f,c)).transpose());
+      }
+      local[k][f] = mesh_boolean_local_overlaps(tree,box);
+    }
+  }
+
+#ifdef IGL_MESH_BOOLEAN_LOCAL_DEBUG
+  cout<<"resolve local facets..."<<endl;
+#endif
+  // Submesh of local facets over the vertices they reference
+  vector<Index> V2L(nv,-1),L2V,LJ;
+  for(int k = 0;k<2;k++)
+  {
+    for(Index f = 0;f<Fk[k].rows();f++)
+    {
+      if(!local[k][f])
+      {
+        continue;
+      }
+      LJ.push_back(f+foff[k]);
+      for(int c = 0;c<3;c++)
+      {
+        const Index v = Fk[k](f,c)+voff[k];
+        if(V2L[v] < 0)
+        {
+          V2L[v] = L2V.size();
+          L2V.push_back(v);
+        }
+      }
+    }
+  }
+  const Index nl = L2V.size();
+  MatrixX3S Vl(nl,3);
+  for(Index l = 0;l<nl;l++)
+  {
+    const int k = L2V[l] < voff[1] ? 0 : 1;
+    Vl.row(l) = Vk[k].row(L2V[l]-voff[k]).template cast<Scalar>();
+  }
+  MatrixX3I Fl(LJ.size(),3);
+  for(Index l = 0;l<(Index)LJ.size();l++)
+  {
+    const int k = LJ[l] < foff[1] ? 0 : 1;
+    for(int c = 0;c<3;c++)
+    {
+      Fl(l,c) = V2L[Fk[k](LJ[l]-foff[k],c)+voff[k]];
+    }
+  }
+  MatrixX3ES SV;
+  MatrixX3I SF;
+  MatrixX2I SIF;
+  VectorXJ SJ;
+  VectorXI SIM;
+  if(Fl.rows() > 0)
+  {
+    RemeshSelfIntersectionsParam params;
+    remesh_self_intersections(Vl,Fl,params,SV,SF,SIF,SJ,SIM);
+  }
+
+  // Output vertices: [VA;VB] followed by new vertices of the remeshing
+  MatrixX3S CV(nv+SV.rows()-nl,3);
+  CV.block(0,0,VA.rows(),3) = Vk[0].template cast<Scalar>();
+  CV.block(VA.rows(),0,VB.rows(),3) = Vk[1].template cast<Scalar>();
+  for(Index s = nl;s<SV.rows();s++)
+  {
+    for(int d = 0;d<3;d++)
+    {
+      CV(nv+s-nl,d) = CGAL::to_double(SV(s,d));
+    }
+  }
+  // Index into CV of (unique) remeshed vertex s
+  const auto & sv2cv = [&](const Index s)->Index
+  {
+    const Index u = SIM(s);
+    return u < nl ? L2V[u] : nv+u-nl;
+  };
+
+#ifdef IGL_MESH_BOOLEAN_LOCAL_DEBUG
+  cout<<"classify..."<<endl;
+#endif
+  // Candidate output facets (indices into CV), the mesh they come from and
+  // whether they are inside the other mesh
+  vector<Index> CF;
+  vector<Index> CJ;
+  vector<int> Ck;
+  vector<char> inside;
+  // Winding number queries of each mesh against the other one
+  vector<vector<double> > Q(2);
+  // Facets of CF classified by each query
+  vector<vector<vector<Index> > > Q2C(2);
+  // Untouched facets: each connected patch is classified by the barycenter of
+  // its first facet
+  for(int k = 0;k<2;k++)
+  {
+    MatrixXi Fn;
+    vector<Index> N2F;
+    for(Index f = 0;f<Fk[k].rows();f++)
+    {
+      if(!local[k][f])
+      {
+        N2F.push_back(f);
+      }
+    }
+    Fn.resize(N2F.size(),3);
+    for(Index n = 0;n<(Index)N2F.size();n++)
+    {
+      Fn.row(n) = Fk[k].row(N2F[n]);
+    }
+    VectorXi C;
+    if(Fn.rows() > 0)
+    {
+      facet_components(Fn,C);
+    }
+    // Query of each patch
+    vector<Index> cc2q(Fn.rows() == 0 ? 0 : C.maxCoeff()+1,-1);
+    for(Index n = 0;n<(Index)N2F.size();n++)
+    {
+      if(cc2q[C(n)] < 0)
+      {
+        cc2q[C(n)] = Q2C[k].size();
+        Q2C[k].push_back(vector<Index>());
+        for(int d = 0;d<3;d++)
+        {
+          Q[k].push_back(
+            (Vk[k](Fn(n,0),d)+Vk[k](Fn(n,1),d)+Vk[k](Fn(n,2),d))/3.);
+        }
+      }
+      auto & q2c = Q2C[k][cc2q[C(n)]];
+      q2c.push_back(CJ.size());
+      for(int c = 0;c<3;c++)
+      {
+        CF.push_back(Fn(n,c)+voff[k]);
+      }
+      CJ.push_back(N2F[n]+foff[k]);
+      Ck.push_back(k);
+    }
+  }
+  // Remeshed facets: patches are split where facets of A and B meet (the
+  // intersection curve), so each is again classified by its first facet
+  const Index sm = SF.rows();
+  vector<int> Sk(sm);
+  for(Index s = 0;s<sm;s++)
+  {
+    Sk[s] = LJ[SJ(s)] < foff[1] ? 0 : 1;
+  }
+  VectorXI SC,Scounts;
+  if(sm > 0)
+  {
+    // Directed edge e = s+c*sm belongs to facet s (over unique vertices)
+    MatrixXi UF(sm,3);
+    for(Index s = 0;s<sm;s++)
+    {
+      for(int c = 0;c<3;c++)
+      {
+        UF(s,c) = SIM(SF(s,c));
+      }
+    }
+    MatrixXi E,uE;
+    VectorXi EMAP,uEC,uEE;
+    unique_edge_map(UF,E,uE,EMAP,uEC,uEE);
+    // Whether facets of both meshes meet at each unique edge
+    vector<char> cut(uE.rows(),0);
+    for(Index u = 0;u<uE.rows();u++)
+    {
+      int seen = 0;
+      for(Index i = uEC(u);i<uEC(u+1);i++)
+      {
+        seen |= 1<<Sk[uEE(i)%sm];
+      }
+      cut[u] = seen == 3;
+    }
+    vector<vector<vector<Index> > > TT(sm,vector<vector<Index> >(3));
+    for(Index s = 0;s<sm;s++)
+    {
+      for(int c = 0;c<3;c++)
+      {
+        const Index u = EMAP(s+c*sm);
+        if(cut[u])
+        {
+          continue;
+        }
+        for(Index i = uEC(u);i<uEC(u+1);i++)
+        {
+          const Index t = uEE(i)%sm;
+          if(t != s)
+          {
+            TT[s][c].push_back(t);
+          }
+        }
+      }
+    }
+    facet_components(TT,SC,Scounts);
+  }
+  // Query of each patch
+  vector<Index> sc2q(Scounts.size(),-1);
+  for(Index s = 0;s<sm;s++)
+  {
+    const int k = Sk[s];
+    if(sc2q[SC(s)] < 0)
+    {
+      sc2q[SC(s)] = Q2C[k].size();
+      Q2C[k].push_back(vector<Index>());
+      for(int d = 0;d<3;d++)
+      {
+        Q[k].push_back(CGAL::to_double(
+          (SV(SF(s,0),d)+SV(SF(s,1),d)+SV(SF(s,2),d))/3.));
+      }
+    }
+    Q2C[k][sc2q[SC(s)]].push_back(CJ.size());
+    for(int c = 0;c<3;c++)
+    {
+      CF.push_back(sv2cv(SF(s,c)));
+    }
+    CJ.push_back(LJ[SJ(s)]);
+    Ck.push_back(k);
+  }
+  inside.resize(CJ.size(),0);
+  if(type != MESH_BOOLEAN_TYPE_RESOLVE)
+  {
+    for(int k = 0;k<2;k++)
+    {
+      const int o = 1-k;
+      const Index nq = Q2C[k].size();
+      if(nq == 0 || Fk[o].rows() == 0)
+      {
+        continue;
+      }
+      const MatrixXd O =
+        Map<const Matrix<double,Dynamic,3,RowMajor> >(Q[k].data(),nq,3);
+      VectorXd W;
+      winding_number(Vk[o],Fk[o],O,W);
+      for(Index q = 0;q<nq;q++)
+      {
+        const double w = fabs(W(q));
+        if(fabs(w-0.5) < 0.25)
+        {
+          // Query lies on (or numerically too close to) the other mesh, e.g.
+          // coplanar overlap: resolve everything globally instead
+#ifdef IGL_MESH_BOOLEAN_LOCAL_DEBUG
+          cout<<"ambiguous winding number "<<W(q)<<", falling back..."<<endl;
+#endif
+          return mesh_boolean(VA,FA,VB,FB,type,VC,FC,J);
+        }
+        for(const auto & c : Q2C[k][q])
+        {
+          inside[c] = w > 0.5;
+        }
+      }
+    }
+  }
+
+#ifdef IGL_MESH_BOOLEAN_LOCAL_DEBUG
+  cout<<"categorize..."<<endl;
+#endif
+  const Index cm = CJ.size();
+  vector<Index> vG;
+  vector<bool> Gflip;
+  for(Index c = 0;c<cm;c++)
+  {
+    switch(type)
+    {
+      case MESH_BOOLEAN_TYPE_RESOLVE:
+        vG.push_back(c);
+        Gflip.push_back(false);
+        break;
+      case MESH_BOOLEAN_TYPE_UNION:
+        if(!inside[c])
+        {
+          vG.push_back(c);
+          Gflip.push_back(false);
+        }
+        break;
+      case MESH_BOOLEAN_TYPE_INTERSECT:
+        if(inside[c])
+        {
+          vG.push_back(c);
+          Gflip.push_back(false);
+        }
+        break;
+      case MESH_BOOLEAN_TYPE_MINUS:
+        // A outside of B and B inside of A flipped
+        if((Ck[c] == 0) != (bool)inside[c])
+        {
+          vG.push_back(c);
+          Gflip.push_back(inside[c]);
+        }
+        break;
+      case MESH_BOOLEAN_TYPE_XOR:
+        vG.push_back(c);
+        Gflip.push_back(inside[c]);
+        break;
+      default:
+        assert(false && "Unknown type");
+        return;
+    }
+  }
+  const Index gm = vG.size();
+  MatrixX3I G(gm,3);
+  J.resize(gm,1);
+  for(Index g = 0;g<gm;g++)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      G(g,c) = CF[3*vG[g]+(Gflip[g] ? 2-c : c)];
+    }
+    J(g) = CJ[vG[g]];
+  }
+  // remove unreferenced vertices
+  VectorXi newIM;
+  remove_unreferenced(CV,G,VC,FC,newIM);
+}
+
+template <
+  typename DerivedVA,
+  typename DerivedFA,
+  typename DerivedVB,
+  typename DerivedFB,
+  typename DerivedVC,
+  typename DerivedFC>
+IGL_INLINE void igl::mesh_boolean_local(
+  const Eigen::PlainObjectBase<DerivedVA > & VA,
+  const Eigen::PlainObjectBase<DerivedFA > & FA,
+  const Eigen::PlainObjectBase<DerivedVB > & VB,
+  const Eigen::PlainObjectBase<DerivedFB > & FB,
+  const MeshBooleanType & type,
+  Eigen::PlainObjectBase<DerivedVC > & VC,
+  Eigen::PlainObjectBase<DerivedFC > & FC)
+{
+  Eigen::Matrix<typename DerivedFC::Index, Eigen::Dynamic,1> J;
+  return mesh_boolean_local(VA,FA,VB,FB,type,VC,FC,J);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+#include <igl/cgal/remesh_self_intersections.cpp>
+template void igl::remesh_self_intersections<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3>, Eigen::Matrix<CGAL::Lazy_exact_nt<CGAL::Gmpq>, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 2, 0, -1, 2>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, igl::RemeshSelfIntersectionsParam const&, Eigen::PlainObjectBase<Eigen::Matrix<CGAL::Lazy_exact_nt<CGAL::Gmpq>, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 2, 0, -1, 2> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::remesh_self_intersections<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3>, Eigen::Matrix<CGAL::Lazy_exact_nt<CGAL::Gmpq>, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 2, 0, -1, 2>, Eigen::Matrix<long, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, igl::RemeshSelfIntersectionsParam const&, Eigen::PlainObjectBase<Eigen::Matrix<CGAL::Lazy_exact_nt<CGAL::Gmpq>, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 2, 0, -1, 2> >&, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+
+// Explicit template specialization
+template void igl::mesh_boolean_local<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::MeshBooleanType const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template void igl::mesh_boolean_local<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::MeshBooleanType const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+#endif
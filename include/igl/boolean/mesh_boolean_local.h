@@ -0,0 +1,84 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef MESH_BOOLEAN_LOCAL_H
+#define MESH_BOOLEAN_LOCAL_H
+
+#include <igl/igl_inline.h>
+#include "MeshBooleanType.h"
+#include <Eigen/Core>
+
+namespace igl
+{
+  //  MESH_BOOLEAN_LOCAL Compute boolean csg operations on two "solid" meshes
+  //  which are each closed, consistently oriented and free of
+  //  self-intersections, only resolving intersections where the meshes meet.
+  //
+  //  Facets of A whose bounding box overlaps a facet of B (found with an AABB
+  //  tree over B) and vice versa are remeshed with
+  //  remesh_self_intersections. All other facets are left untouched: each
+  //  connected patch of them cannot cross the other mesh, so it is classified
+  //  as inside or outside with a single winding number query. So is each
+  //  patch of remeshed facets, split where facets of A and B meet. The cost
+  //  of the exact remeshing thus scales with the size of the intersection
+  //  rather than the size of the meshes.
+  //
+  //  If a patch cannot be classified (e.g. it lies on the other mesh, as for
+  //  coplanar overlaps) this falls back to mesh_boolean.
+  //
+  //  Inputs:
+  //    VA  #VA by 3 list of vertex positions of first mesh
+  //    FA  #FA by 3 list of triangle indices into VA
+  //    VB  #VB by 3 list of vertex positions of second mesh
+  //    FB  #FB by 3 list of triangle indices into VB
+  //    type  type of boolean operation
+  //  Outputs:
+  //    VC  #VC by 3 list of vertex positions of boolean result mesh
+  //    FC  #FC by 3 list of triangle indices into VC
+  //    J  #FC list of indices into [FA;FB] revealing "birth" facet
+  //
+  //  See also: mesh_boolean
+  //
+  template <
+    typename DerivedVA,
+    typename DerivedFA,
+    typename DerivedVB,
+    typename DerivedFB,
+    typename DerivedVC,
+    typename DerivedFC,
+    typename DerivedJ>
+  IGL_INLINE void mesh_boolean_local(
+    const Eigen::PlainObjectBase<DerivedVA > & VA,
+    const Eigen::PlainObjectBase<DerivedFA > & FA,
+    const Eigen::PlainObjectBase<DerivedVB > & VB,
+    const Eigen::PlainObjectBase<DerivedFB > & FB,
+    const MeshBooleanType & type,
+    Eigen::PlainObjectBase<DerivedVC > & VC,
+    Eigen::PlainObjectBase<DerivedFC > & FC,
+    Eigen::PlainObjectBase<DerivedJ > & J);
+  template <
+    typename DerivedVA,
+    typename DerivedFA,
+    typename DerivedVB,
+    typename DerivedFB,
+    typename DerivedVC,
+    typename DerivedFC>
+  IGL_INLINE void mesh_boolean_local(
+    const Eigen::PlainObjectBase<DerivedVA > & VA,
+    const Eigen::PlainObjectBase<DerivedFA > & FA,
+    const Eigen::PlainObjectBase<DerivedVB > & VB,
+    const Eigen::PlainObjectBase<DerivedFB > & FB,
+    const MeshBooleanType & type,
+    Eigen::PlainObjectBase<DerivedVC > & VC,
+    Eigen::PlainObjectBase<DerivedFC > & FC);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "mesh_boolean_local.cpp"
+#endif
+
+#endif
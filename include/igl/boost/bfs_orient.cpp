@@ -35,21 +35,19 @@ IGL_INLINE void igl::bfs_orient(
   {
     FF = F;
   }
+  // first member of each patch
+  VectorXi first = VectorXi::Constant(num_cc,-1);
+  for(int f = m-1;f>=0;f--)
+  {
+    first(C(f)) = f;
+  }
   // loop over patches
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
   for(int c = 0;c<num_cc;c++)
   {
     queue<int> Q;
-    // find first member of patch c
-    for(int f = 0;f<FF.rows();f++)
-    {
-      if(C(f) == c)
-      {
-        Q.push(f);
-        break;
-      }
-    }
-    assert(!Q.empty());
+    assert(first(c) >= 0);
+    Q.push(first(c));
     while(!Q.empty())
     {
       const int f = Q.front();
@@ -6,13 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "components.h"
-#include <igl/adjacency_matrix.h>
-
-//#include <boost/graph/adjacency_matrix.hpp>
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/connected_components.hpp>
-#include <iostream>
-#include <vector>
+#include <igl/union_find_components.h>
 #include <cassert>
 
 template <typename AScalar, typename DerivedC>
@@ -21,23 +15,11 @@ IGL_INLINE void igl::components(
   Eigen::PlainObjectBase<DerivedC> & C)
 {
   assert(A.rows() == A.cols());
-  using namespace Eigen;
-  // THIS IS DENSE:
-  //boost::adjacency_matrix<boost::undirectedS> bA(A.rows());
-  boost::adjacency_list<boost::vecS,boost::vecS,boost::undirectedS> bA(A.rows());
-  for(int j=0; j<A.outerSize();j++)
-  {
-    // Iterate over inside
-    for(typename SparseMatrix<AScalar>::InnerIterator it (A,j); it; ++it)
-    {
-      if(0 != it.value())
-      {
-        boost::add_edge(it.row(),it.col(),bA);
-      }
-    }
-  }
-  C.resize(A.rows(),1);
-  boost::connected_components(bA,C.data());
+  // Building a boost::adjacency_list does not scale to large meshes, merge
+  // nonzeros into a concurrent union-find instead (same numbering as
+  // boost::connected_components)
+  Eigen::VectorXi counts;
+  union_find_components(A,C,counts);
 }
 
 template <typename DerivedF, typename DerivedC>
@@ -45,9 +27,10 @@ IGL_INLINE void igl::components(
   const Eigen::PlainObjectBase<DerivedF> & F,
   Eigen::PlainObjectBase<DerivedC> & C)
 {
-  Eigen::SparseMatrix<typename DerivedC::Scalar> A;
-  igl::adjacency_matrix(F,A);
-  return components(A,C);
+  // Vertices of a face are connected by its edges, so there is no need to
+  // build the adjacency matrix
+  Eigen::VectorXi counts;
+  union_find_components(F.size() ? F.maxCoeff()+1 : 0,F,C,counts);
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -6,12 +6,10 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "orientable_patches.h"
-#include "components.h"
-#include <igl/sort.h>
-#include <igl/unique.h>
-#include <igl/matlab_format.h>
+#include <igl/mesh_connectivity.h>
+#include <igl/union_find_components.h>
+#include <algorithm>
 #include <vector>
-#include <iostream>
 
 template <typename DerivedF, typename DerivedC, typename AScalar>
 IGL_INLINE void igl::orientable_patches(
@@ -21,73 +19,81 @@ IGL_INLINE void igl::orientable_patches(
 {
   using namespace Eigen;
   using namespace std;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
 
   // simplex size
   assert(F.cols() == 3);
+  const int m = F.rows();
 
-  // List of all "half"-edges: 3*#F by 2
-  Matrix<typename DerivedF::Scalar, Dynamic, 2> allE,sortallE,uE;
-  allE.resize(F.rows()*3,2);
-  Matrix<int,Dynamic,2> IX;
-  VectorXi IA,IC;
-  allE.block(0*F.rows(),0,F.rows(),1) = F.col(1);
-  allE.block(0*F.rows(),1,F.rows(),1) = F.col(2);
-  allE.block(1*F.rows(),0,F.rows(),1) = F.col(2);
-  allE.block(1*F.rows(),1,F.rows(),1) = F.col(0);
-  allE.block(2*F.rows(),0,F.rows(),1) = F.col(0);
-  allE.block(2*F.rows(),1,F.rows(),1) = F.col(1);
-  // Sort each row
-  sort(allE,2,true,sortallE,IX);
-  //IC(i) tells us where to find sortallE(i,:) in uE: 
-  // so that sortallE(i,:) = uE(IC(i),:)
-  unique_rows(sortallE,uE,IA,IC);
-  // uE2FT(e,f) = 1 means face f is adjacent to unique edge e
-  vector<Triplet<AScalar> > uE2FTijv(IC.rows());
-  for(int e = 0;e<IC.rows();e++)
-  {
-    uE2FTijv[e] = Triplet<AScalar>(e%F.rows(),IC(e),1);
-  }
-  SparseMatrix<AScalar> uE2FT(F.rows(),uE.rows());
-  uE2FT.setFromTriplets(uE2FTijv.begin(),uE2FTijv.end());
-  // kill non-manifold edges
-  for(int j=0; j<(int)uE2FT.outerSize();j++)
+  // Directed edges of each unique edge
+  mesh_connectivity_data data;
+  mesh_connectivity(
+    F,0,MESH_CONNECTIVITY_E | MESH_CONNECTIVITY_UE2E,data);
+  const VectorXi & EMAP = data.EMAP;
+  const VectorXi & uEC = data.uEC;
+  const VectorXi & uEE = data.uEE;
+  // Faces adjacent to f across manifold edges (at most 3) and f itself if any
+  // of its edges is manifold (non-manifold edges are ignored)
+  const auto neighbors = [&](const int f, int * N)->int
   {
-    int degree = 0;
-    for(typename SparseMatrix<AScalar>::InnerIterator it (uE2FT,j); it; ++it)
-    {
-      degree++;
-    }
-    // Iterate over inside
-    if(degree > 2)
+    int k = 0;
+    bool self = false;
+    for(int c = 0;c<3;c++)
     {
-      for(typename SparseMatrix<AScalar>::InnerIterator it (uE2FT,j); it; ++it)
+      const int u = EMAP(f+c*m);
+      const int degree = uEC(u+1)-uEC(u);
+      if(degree > 2)
+      {
+        continue;
+      }
+      self = true;
+      if(degree == 2)
       {
-        uE2FT.coeffRef(it.row(),it.col()) = 0;
+        const int e = uEE(uEC(u)) == f+c*m ? uEE(uEC(u)+1) : uEE(uEC(u));
+        N[k++] = e%m;
       }
     }
+    if(self)
+    {
+      N[k++] = f;
+    }
+    std::sort(N,N+k);
+    return std::unique(N,N+k)-N;
+  };
+  // Face-face adjacency matrix, assembled directly in compressed form (it is
+  // symmetric, so column f lists the neighbors of f)
+  vector<int> count(m+1,0);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int f = 0;f<m;f++)
+  {
+    int N[4];
+    count[f+1] = neighbors(f,N);
+  }
+  for(int f = 0;f<m;f++)
+  {
+    count[f+1] += count[f];
   }
-  // Face-face Adjacency matrix
-  SparseMatrix<AScalar> uE2F;
-  uE2F = uE2FT.transpose().eval();
-  A = uE2FT*uE2F;
-  // All ones
-  for(int j=0; j<A.outerSize();j++)
+  A.resize(m,m);
+  A.resizeNonZeros(count[m]);
+  copy(count.begin(),count.end(),A.outerIndexPtr());
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int f = 0;f<m;f++)
   {
-    // Iterate over inside
-    for(typename SparseMatrix<AScalar>::InnerIterator it (A,j); it; ++it)
+    int N[4];
+    const int k = neighbors(f,N);
+    for(int i = 0;i<k;i++)
     {
-      if(it.value() > 1)
-      {
-        A.coeffRef(it.row(),it.col()) = 1;
-      }
+      A.innerIndexPtr()[count[f]+i] = N[i];
+      A.valuePtr()[count[f]+i] = 1;
     }
   }
   //% Connected components are patches
   //%C = components(A); % alternative to graphconncomp from matlab_bgl
   //[~,C] = graphconncomp(A);
-  // graph connected components using boost
-  components(A,C);
-
+  VectorXi counts;
+  union_find_components(A,C,counts);
 }
 
 #ifdef IGL_STATIC_LIBRARY
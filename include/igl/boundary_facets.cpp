@@ -99,8 +99,6 @@ IGL_INLINE void igl::boundary_facets(
 }
 
 #ifndef IGL_NO_EIGEN
-#include "list_to_matrix.h"
-#include "matrix_to_list.h"
 
 template <typename DerivedT, typename DerivedF>
 IGL_INLINE void igl::boundary_facets(
@@ -110,12 +108,52 @@ IGL_INLINE void igl::boundary_facets(
   assert(T.cols() == 0 || T.cols() == 4 || T.cols() == 3);
   using namespace std;
   using namespace Eigen;
-  // Cop out: use vector of vectors version
-  vector<vector<typename Eigen::PlainObjectBase<DerivedT>::Scalar> > vT;
-  matrix_to_list(T,vT);
-  vector<vector<typename Eigen::PlainObjectBase<DerivedF>::Scalar> > vF;
-  boundary_facets(vT,vF);
-  list_to_matrix(vF,F);
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  typedef typename DerivedF::Scalar Index;
+  const int m = T.rows();
+  const int s = T.cols();
+  if(m == 0)
+  {
+    F.resize(0,s == 0 ? 0 : s-1);
+    return;
+  }
+  // All facets (same order and orientation as the list version above)
+  static const int tet_faces[4][3] = {{1,3,2},{0,2,3},{0,3,1},{0,1,2}};
+  static const int tri_faces[3][2] = {{1,2},{2,0},{0,1}};
+  Matrix<Index,Dynamic,Dynamic> allF(m*s,s-1);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int i = 0;i<m;i++)
+  {
+    for(int j = 0;j<s;j++)
+    {
+      for(int c = 0;c<s-1;c++)
+      {
+        allF(i*s+j,c) = T(i,s == 4 ? tet_faces[j][c] : tri_faces[j][c]);
+      }
+    }
+  }
+  // Counts from a parallel hash table rather than a sorted map
+  VectorXi C;
+  face_occurrences(allF,C);
+  // Keep everything not shared by exactly two simplices (including
+  // non-manifold facets)
+  vector<int> keep;
+  keep.reserve(m);
+  for(int f = 0;f<(int)C.size();f++)
+  {
+    if(C(f) != 2)
+    {
+      keep.push_back(f);
+    }
+  }
+  F.resize(keep.size(),s-1);
+#pragma omp parallel for if (keep.size()>IGL_OMP_MIN_VALUE)
+  for(int k = 0;k<(int)keep.size();k++)
+  {
+    F.row(k) = allF.row(keep[k]);
+  }
 }
 
 template <typename DerivedT, typename Ret>
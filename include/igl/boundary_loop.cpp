@@ -6,11 +6,8 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "boundary_loop.h"
-#include "slice.h"
-#include "triangle_triangle_adjacency.h"
-#include "vertex_triangle_adjacency.h"
-#include "is_border_vertex.h"
-#include <set>
+#include "face_occurrences.h"
+#include <vector>
 
 template <typename DerivedF, typename Index>
 IGL_INLINE void igl::boundary_loop(
@@ -19,71 +16,77 @@ IGL_INLINE void igl::boundary_loop(
 {
   using namespace std;
   using namespace Eigen;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
 
   if(F.rows() == 0)
     return;
 
-  MatrixXd Vdummy(F.maxCoeff()+1,1);
-  MatrixXi TT,TTi;
-  vector<std::vector<int> > VF, VFi;
-  triangle_triangle_adjacency(Vdummy,F,TT,TTi);
-  vertex_triangle_adjacency(Vdummy,F,VF,VFi);
-
-  vector<bool> unvisited = is_border_vertex(Vdummy,F);
-  set<int> unseen;
-  for (size_t i = 0; i < unvisited.size(); ++i)
+  const int m = F.rows();
+  const int n = F.maxCoeff()+1;
+  // Directed edge f*3+i goes from F(f,i) to F(f,i+1). Boundary edges are
+  // found in a single (parallel, hashed) pass.
+  MatrixXi E(m*3,2);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int f = 0;f<m;f++)
   {
-    if (unvisited[i])
-      unseen.insert(unseen.end(),i);
+    for(int i = 0;i<3;i++)
+    {
+      E(f*3+i,0) = F(f,i);
+      E(f*3+i,1) = F(f,(i+1)%3);
+    }
   }
-
-  while (!unseen.empty())
+  VectorXi C;
+  face_occurrences(E,C);
+  // Outgoing boundary edges of each vertex (in order of incident faces) as
+  // flat linked lists
+  vector<int> NI(n+1,0);
+  for(int e = 0;e<m*3;e++)
+  {
+    if(C(e) == 1)
+    {
+      NI[E(e,0)+1]++;
+    }
+  }
+  for(int v = 0;v<n;v++)
+  {
+    NI[v+1] += NI[v];
+  }
+  vector<int> next(NI[n]);
   {
+    vector<int> k(NI.begin(),NI.end()-1);
+    for(int e = 0;e<m*3;e++)
+    {
+      if(C(e) == 1)
+      {
+        next[k[E(e,0)]++] = E(e,1);
+      }
+    }
+  }
+  // Walk each loop starting from its smallest vertex
+  vector<bool> visited(n,false);
+  for(int start = 0;start<n;start++)
+  {
+    if(visited[start] || NI[start] == NI[start+1])
+    {
+      continue;
+    }
     vector<Index> l;
-
-    // Get first vertex of loop
-    int start = *unseen.begin();
-    unseen.erase(unseen.begin());
-    unvisited[start] = false;
-    l.push_back(start);
-
-    bool done = false;
-    while (!done)
+    int v = start;
+    while(v >= 0)
     {
-      // Find next vertex
-      bool newBndEdge = false;
-      int v = l[l.size()-1];
-      int next;
-      for (int i = 0; i < (int)VF[v].size() && !newBndEdge; i++)
+      visited[v] = true;
+      l.push_back(v);
+      int w = -1;
+      for(int k = NI[v];k<NI[v+1] && w < 0;k++)
       {
-        int fid = VF[v][i];
-
-        if (TT.row(fid).minCoeff() < 0.) // Face contains boundary edge
+        if(!visited[next[k]])
         {
-          int vLoc = -1;
-          if (F(fid,0) == v) vLoc = 0;
-          if (F(fid,1) == v) vLoc = 1;
-          if (F(fid,2) == v) vLoc = 2;
-
-          int vNext = F(fid,(vLoc + 1) % F.cols());
-
-          newBndEdge = false;
-          if (unvisited[vNext] && TT(fid,vLoc) < 0)
-          {
-            next = vNext;
-            newBndEdge = true;
-          }
+          w = next[k];
         }
       }
-
-      if (newBndEdge)
-      {
-        l.push_back(next);
-        unseen.erase(next);
-        unvisited[next] = false;
-      }
-      else
-        done = true;
+      v = w;
     }
     L.push_back(l);
   }
@@ -14,7 +14,9 @@
 
 namespace igl
 {
-  // Compute list of ordered boundary loops for a manifold mesh.
+  // Compute list of ordered boundary loops for a manifold mesh. Boundary edges
+  // are found with a parallel hash of all edges and each loop is chained by
+  // following the next boundary edge of each vertex.
   //
   // Templates:
   //  Index  index type
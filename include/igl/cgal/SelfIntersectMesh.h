@@ -20,6 +20,9 @@
 #ifndef IGL_FIRST_HIT_EXCEPTION
 #define IGL_FIRST_HIT_EXCEPTION 10
 #endif
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
 
 // The easiest way to keep track of everything is to use a class
 
@@ -72,13 +75,14 @@ namespace igl
       typedef CGAL::Constrained_Delaunay_triangulation_2<Kernel,TDS_2,Itag> 
         CDT_2;
       typedef CGAL::Constrained_triangulation_plus_2<CDT_2> CDT_plus_2;
-      // Axis-align boxes for all-pairs self-intersection detection
-      typedef std::vector<Triangle_3> Triangles;
-      typedef typename Triangles::iterator TrianglesIterator;
-      typedef typename Triangles::const_iterator TrianglesConstIterator;
-      typedef 
-        CGAL::Box_intersection_d::Box_with_handle_d<double,3,TrianglesIterator> 
-        Box;
+      // Filtered double precision predicates (exact predicates, inexact
+      // constructions) used to rule out pairs before any Kernel object is
+      // constructed
+      typedef CGAL::Exact_predicates_inexact_constructions_kernel 
+        FilterKernel;
+      typedef CGAL::Point_3<FilterKernel>    FilterPoint_3;
+      typedef CGAL::Segment_3<FilterKernel>  FilterSegment_3; 
+      typedef CGAL::Triangle_3<FilterKernel> FilterTriangle_3; 
 
       // Input mesh
       const Eigen::PlainObjectBase<DerivedV> & V;
@@ -88,8 +92,17 @@ namespace igl
       Index count;
       typedef std::vector<CGAL::Object> ObjectList;
       std::vector<ObjectList > F_objects;
-      Triangles T;
       typedef std::vector<Index> IndexList;
+      // Axis-align boxes for all-pairs self-intersection detection, each box
+      // holds a handle to its face's index
+      IndexList face_ids;
+      typedef 
+        CGAL::Box_intersection_d::Box_with_handle_d<
+          double,3,typename IndexList::iterator> 
+        Box;
+      // Pairs of faces whose boxes intersect (in the order found by
+      // box_self_intersection_d)
+      std::vector<std::pair<Index,Index> > candidates;
       IndexList lIF;
       std::vector<bool> offensive;
       std::vector<Index> offending_index;
@@ -130,23 +143,61 @@ namespace igl
       //   fa  index of face A in F
       //   fb  index of face B in F
       inline void count_intersection( const Index fa, const Index fb);
-      // Helper function for box_intersect. Intersect two triangles A and B,
+      // Helper function to build the triangle of face f from V. Each call
+      // returns new kernel objects (sharing nothing with other calls), so
+      // that with a lazy exact kernel threads never touch the same
+      // representation.
+      //
+      // Inputs:
+      //   f  index of face in F
+      inline Triangle_3 face_triangle(const Index f) const;
+      // Helper function to compute the bounding box of face f (without
+      // constructing Kernel objects if V is floating point)
+      //
+      // Inputs:
+      //   f  index of face in F
+      inline CGAL::Bbox_3 face_bbox(const Index f) const;
+      // Helper function to rule out a pair of faces whose boxes intersect
+      // using filtered double precision predicates on V. This repeats the
+      // classification of test_pair using only predicates (which are exact),
+      // so it never rejects a pair test_pair would accept.
+      //
+      // Inputs:
+      //   fa  index of face A in F
+      //   fb  index of face B in F
+      // Returns false only if A and B certainly do not intersect (besides
+      // shared vertices)
+      inline bool filter_pair(const Index fa, const Index fb) const;
+      // Helper function to test a pair of faces whose boxes intersect. Only
+      // reads shared state, so pairs can be tested in parallel.
+      //
+      // Inputs:
+      //   fa  index of face A in F
+      //   fb  index of face B in F
+      // Outputs:
+      //   objects  intersection objects (point,segment,triangle,polygon) of A
+      //     and B (unless params.detect_only)
+      // Returns true only if A and B intersect (besides shared vertices)
+      inline bool test_pair(
+          const Index fa,
+          const Index fb,
+          ObjectList & objects) const;
+      // Helper function for test_pair. Intersect two triangles A and B,
       // append the intersection object (point,segment,triangle) to a running
-      // list for A and B
+      // list
       //
       // Inputs:
       //   A  triangle in 3D
       //   B  triangle in 3D
-      //   fa  index of A in F (and F_objects)
-      //   fb  index of A in F (and F_objects)
+      // Outputs:
+      //   objects  running list of intersection objects
       // Returns true only if A intersects B
       //
       inline bool intersect(
           const Triangle_3 & A, 
           const Triangle_3 & B, 
-          const Index fa,
-          const Index fb);
-      // Helper function for box_intersect. In the case where A and B have
+          ObjectList & objects) const;
+      // Helper function for test_pair. In the case where A and B have
       // already been identified to share a vertex, then we only want to add
       // possible segment intersections. Assumes truly duplicate triangles are
       // not given as input
@@ -154,41 +205,40 @@ namespace igl
       // Inputs:
       //   A  triangle in 3D
       //   B  triangle in 3D
-      //   fa  index of A in F (and F_objects)
-      //   fb  index of B in F (and F_objects)
-      //   va  index of shared vertex in A (and F_objects)
-      //   vb  index of shared vertex in B (and F_objects)
+      //   va  index of shared vertex in A
+      //   vb  index of shared vertex in B
+      // Outputs:
+      //   objects  running list of intersection objects
       //// Returns object of intersection (should be Segment or point)
       //   Returns true if intersection (besides shared point)
       //
       inline bool single_shared_vertex(
           const Triangle_3 & A,
           const Triangle_3 & B,
-          const Index fa,
-          const Index fb,
           const Index va,
-          const Index vb);
+          const Index vb,
+          ObjectList & objects) const;
       // Helper handling one direction
       inline bool single_shared_vertex(
           const Triangle_3 & A,
           const Triangle_3 & B,
-          const Index fa,
-          const Index fb,
-          const Index va);
-      // Helper function for box_intersect. In the case where A and B have
+          const Index va,
+          ObjectList & objects) const;
+      // Helper function for test_pair. In the case where A and B have
       // already been identified to share two vertices, then we only want to add
       // a possible coplanar (Triangle) intersection. Assumes truly degenerate
       // facets are not givin as input.
       inline bool double_shared_vertex(
           const Triangle_3 & A,
           const Triangle_3 & B,
-          const Index fa,
-          const Index fb);
+          ObjectList & objects) const;
 
     public:
       // Callback function called during box self intersections test. Means
-      // boxes a and b intersect. This method then checks if the triangles in
-      // each box intersect and if so, then processes the intersections
+      // boxes a and b intersect. This method records the pair of faces as a
+      // candidate, candidates are tested afterwards (in parallel). If
+      // params.first_only then the pair is tested right away instead, and the
+      // search stops at the first intersecting pair.
       //
       // Inputs:
       //   a  box containing a triangle
@@ -227,8 +277,6 @@ namespace igl
 
 // Implementation
 
-#include "mesh_to_cgal_triangle_list.h"
-
 #include <igl/REDRUM.h>
 #include <igl/get_seconds.h>
 #include <igl/C_STR.h>
@@ -236,6 +284,7 @@ namespace igl
 
 #include <functional>
 #include <algorithm>
+#include <type_traits>
 #include <exception>
 #include <cassert>
 #include <iostream>
@@ -320,7 +369,8 @@ inline igl::SelfIntersectMesh<
   F(F),
   count(0),
   F_objects(F.rows()),
-  T(),
+  face_ids(),
+  candidates(),
   lIF(),
   offensive(F.rows(),false),
   offending_index(F.rows(),-1),
@@ -343,20 +393,15 @@ inline igl::SelfIntersectMesh<
 #endif
 
   // Compute and process self intersections
-  mesh_to_cgal_triangle_list(V,F,T);
-#ifdef IGL_SELFINTERSECTMESH_DEBUG
-  cout<<"mesh_to_cgal_triangle_list: "<<tictoc()<<endl;
-#endif
   // http://www.cgal.org/Manual/latest/doc_html/cgal_manual/Box_intersection_d/Chapter_main.html#Section_63.5 
   // Create the corresponding vector of bounding boxes
+  face_ids.resize(F.rows());
   std::vector<Box> boxes;
-  boxes.reserve(T.size());
-  for ( 
-    TrianglesIterator tit = T.begin(); 
-    tit != T.end(); 
-    ++tit)
+  boxes.reserve(F.rows());
+  for(Index f = 0;f<F.rows();f++)
   {
-    boxes.push_back(Box(tit->bbox(), tit));
+    face_ids[f] = f;
+    boxes.push_back(Box(face_bbox(f), face_ids.begin()+f));
   }
   // Leapfrog callback
   std::function<void(const Box &a,const Box &b)> cb = 
@@ -368,7 +413,8 @@ inline igl::SelfIntersectMesh<
 #ifdef IGL_SELFINTERSECTMESH_DEBUG
   cout<<"boxes and bind: "<<tictoc()<<endl;
 #endif
-  // Run the self intersection algorithm with all defaults
+  // Run the self intersection algorithm with all defaults, this only
+  // collects candidate pairs (unless params.first_only)
   try{
     CGAL::box_self_intersection_d(boxes.begin(), boxes.end(),cb);
   }catch(int e)
@@ -383,6 +429,74 @@ inline igl::SelfIntersectMesh<
 #ifdef IGL_SELFINTERSECTMESH_DEBUG
   cout<<"box_self_intersection_d: "<<tictoc()<<endl;
 #endif
+  // Test candidate pairs. The intersection objects of a pair are kept (with
+  // its candidate index) only if it hits. Each face of a hit gets its own
+  // objects, constructed by testing the pair again: lazy exact kernel objects
+  // update their cached exact values without locking, so faces that are
+  // triangulated in parallel below must never share them.
+  const Index ncand = candidates.size();
+  struct Hit
+  {
+    Index c;
+    ObjectList objects_a, objects_b;
+  };
+  vector<Hit> hits;
+  // CGAL's lazy exact kernel keeps its shared default objects per thread
+  // only if it is built with thread support
+#ifdef CGAL_HAS_THREADS
+#   pragma omp parallel if (ncand>IGL_OMP_MIN_VALUE)
+#endif
+  {
+    vector<Hit> thread_hits;
+    ObjectList objects;
+#   pragma omp for schedule(dynamic,64) nowait
+    for(Index c = 0;c<ncand;c++)
+    {
+      const Index fa = candidates[c].first;
+      const Index fb = candidates[c].second;
+      objects.clear();
+      if(filter_pair(fa,fb) && test_pair(fa,fb,objects))
+      {
+        thread_hits.push_back(Hit());
+        Hit & h = thread_hits.back();
+        h.c = c;
+        h.objects_a.swap(objects);
+        if(!params.detect_only)
+        {
+          test_pair(fa,fb,h.objects_b);
+        }
+      }
+    }
+#   pragma omp critical(igl_SelfIntersectMesh_hits)
+    {
+      for(auto & h : thread_hits)
+      {
+        hits.push_back(Hit());
+        hits.back().c = h.c;
+        hits.back().objects_a.swap(h.objects_a);
+        hits.back().objects_b.swap(h.objects_b);
+      }
+    }
+  }
+  // Merge in candidate order (the order pairs were processed in serially)
+  std::sort(hits.begin(),hits.end(),
+    [](const Hit & a, const Hit & b){ return a.c < b.c; });
+  for(const auto & h : hits)
+  {
+    const Index fa = candidates[h.c].first;
+    const Index fb = candidates[h.c].second;
+    // Append to each triangle's running list
+    F_objects[fa].insert(
+      F_objects[fa].end(),h.objects_a.begin(),h.objects_a.end());
+    F_objects[fb].insert(
+      F_objects[fb].end(),h.objects_b.begin(),h.objects_b.end());
+    count_intersection(fa,fb);
+  }
+  candidates.clear();
+  hits.clear();
+#ifdef IGL_SELFINTERSECTMESH_DEBUG
+  cout<<"test pairs: "<<tictoc()<<endl;
+#endif
 
   // Convert lIF to Eigen matrix
   assert(lIF.size()%2 == 0);
@@ -419,28 +533,36 @@ inline igl::SelfIntersectMesh<
   typedef vector<Point_3> Point_3List;
   Point_3List NV;
   Index NV_count = 0;
-  vector<CDT_plus_2> cdt(offending.size());
-  vector<Plane_3> P(offending.size());
-  // Use map for *all* faces
-  map<typename CDT_plus_2::Vertex_handle,Index> v2i;
+  // Vertices of each offending triangle's CDT lifted back to 3D (the first
+  // three are its corners)
+  vector<Point_3List> cdt_points(offending.size());
+  // Index of each of these in VV
+  vector<IndexList> cdt_index(offending.size());
   // Loop over offending triangles
   const size_t noff = offending.size();
 #ifdef IGL_SELFINTERSECTMESH_DEBUG
   double t_proj_del = 0;
 #endif
-  // Unfortunately it looks like CGAL has trouble allocating memory when
-  // multiple openmp threads are running. Crashes durring CDT...
-//# pragma omp parallel for if (noff>1000)
+  // Triangulate each offending triangle independently: every CDT only touches
+  // its own triangle and intersection objects (no kernel object is shared
+  // between faces, see above). NF[o] indexes cdt_points[o].
+#ifdef CGAL_HAS_THREADS
+#   pragma omp parallel for schedule(dynamic) if (noff>IGL_OMP_MIN_VALUE)
+#endif
   for(Index o = 0;o<(Index)noff;o++)
   {
     // index in F
     const Index f = offending[o];
+    // Kernel objects are only ever constructed for offending faces
+    const Triangle_3 Tf = face_triangle(f);
+    CDT_plus_2 cdt;
     {
 #ifdef IGL_SELFINTERSECTMESH_DEBUG
       const double t_before = get_seconds();
 #endif
-      projected_delaunay(T[f],F_objects[f],cdt[o]);
+      projected_delaunay(Tf,F_objects[f],cdt);
 #ifdef IGL_SELFINTERSECTMESH_DEBUG
+#     pragma omp atomic
       t_proj_del += (get_seconds()-t_before);
 #endif
     }
@@ -450,99 +572,38 @@ inline igl::SelfIntersectMesh<
     // Q: Then, can't we first get the 2D delaunay triangulation, then lift it
     // to 3D and flip any offending edges?
     // Plane of projection (also used by projected_delaunay)
-    P[o] = Plane_3(T[f].vertex(0),T[f].vertex(1),T[f].vertex(2));
-    // Build index map
+    const Plane_3 P(Tf.vertex(0),Tf.vertex(1),Tf.vertex(2));
+    // Build local index map
+    map<typename CDT_plus_2::Vertex_handle,Index> v2i;
     {
       Index i=0;
       for(
-        typename CDT_plus_2::Finite_vertices_iterator vit = cdt[o].finite_vertices_begin();
-        vit != cdt[o].finite_vertices_end();
+        typename CDT_plus_2::Finite_vertices_iterator vit = cdt.finite_vertices_begin();
+        vit != cdt.finite_vertices_end();
         ++vit)
       {
+        cdt_points[o].push_back(P.to_3d(vit->point()));
+#ifndef NDEBUG
         if(i<3)
         {
-          //cout<<T[f].vertex(i)<<
-          //  (T[f].vertex(i) == P[o].to_3d(vit->point())?" == ":" != ")<<
-          //  P[o].to_3d(vit->point())<<endl;
-#ifndef NDEBUG
           // I want to be sure that the original corners really show up as the
           // original corners of the CDT. I.e. I don't trust CGAL to maintain
           // the order
-          assert(T[f].vertex(i) == P[o].to_3d(vit->point()));
-#endif
-          // For first three, use original index in F
-//#   pragma omp critical
-          v2i[vit] = F(f,i);
-        }else
-        {
-          const Point_3 vit_point_3 = P[o].to_3d(vit->point());
-          // First look up each edge's neighbors to see if exact point has
-          // already been added (This makes everything a bit quadratic)
-          bool found = false;
-          for(int e = 0; e<3 && !found;e++)
-          {
-            // Index of F's eth edge in V
-            Index i = F(f,(e+1)%3);
-            Index j = F(f,(e+2)%3);
-            // Be sure that i<j
-            if(i>j)
-            {
-              swap(i,j);
-            }
-            assert(edge2faces.count(EMK(i,j))==1);
-            // loop over neighbors
-            for(
-              typename IndexList::const_iterator nit = edge2faces[EMK(i,j)].begin();
-              nit != edge2faces[EMK(i,j)].end() && !found;
-              nit++)
-            {
-              // don't consider self
-              if(*nit == f)
-              {
-                continue;
-              }
-              // index of neighbor in offending (to find its cdt)
-              Index no = offending_index[*nit];
-              // Loop over vertices of that neighbor's cdt (might not have been
-              // processed yet, but then it's OK because it'll just be empty)
-              for(
-                  typename CDT_plus_2::Finite_vertices_iterator uit = cdt[no].finite_vertices_begin();
-                  uit != cdt[no].finite_vertices_end() && !found;
-                  ++uit)
-              {
-                if(vit_point_3 == P[no].to_3d(uit->point()))
-                {
-                  assert(v2i.count(uit) == 1);
-//#   pragma omp critical
-                  v2i[vit] = v2i[uit];
-                  found = true;
-                }
-              }
-            }
-          }
-          if(!found)
-          {
-//#   pragma omp critical
-            {
-              v2i[vit] = V.rows()+NV_count;
-              NV.push_back(vit_point_3);
-              NV_count++;
-            }
-          }
+          assert(Tf.vertex(i) == cdt_points[o].back());
         }
+#endif
+        v2i[vit] = i;
         i++;
       }
     }
     {
       Index i = 0;
       // Resize to fit new number of triangles
-      NF[o].resize(cdt[o].number_of_faces(),3);
-//#   pragma omp atomic
-      NF_count+=NF[o].rows();
+      NF[o].resize(cdt.number_of_faces(),3);
       // Append new faces to NF
       for(
-        typename CDT_plus_2::Finite_faces_iterator fit = cdt[o].finite_faces_begin();
-        fit != cdt[o].finite_faces_end();
+        typename CDT_plus_2::Finite_faces_iterator fit = cdt.finite_faces_begin();
+        fit != cdt.finite_faces_end();
         ++fit)
       {
         NF[o](i,0) = v2i[fit->vertex(0)];
@@ -555,6 +616,78 @@ inline igl::SelfIntersectMesh<
 #ifdef IGL_SELFINTERSECTMESH_DEBUG
   cout<<"CDT: "<<tictoc()<<"  "<<t_proj_del<<endl;
 #endif
+  // Number vertices in order of offending triangles. Points shared with
+  // already numbered neighbors (across an edge) reuse their index.
+  for(Index o = 0;o<(Index)noff;o++)
+  {
+    // index in F
+    const Index f = offending[o];
+    const Point_3List & points = cdt_points[o];
+    cdt_index[o].resize(points.size());
+    for(Index i = 0;i<(Index)points.size();i++)
+    {
+      if(i<3)
+      {
+        // For first three, use original index in F
+        cdt_index[o][i] = F(f,i);
+        continue;
+      }
+      const Point_3 & vit_point_3 = points[i];
+      // First look up each edge's neighbors to see if exact point has
+      // already been added (This makes everything a bit quadratic)
+      bool found = false;
+      for(int e = 0; e<3 && !found;e++)
+      {
+        // Index of F's eth edge in V
+        Index vi = F(f,(e+1)%3);
+        Index vj = F(f,(e+2)%3);
+        // Be sure that vi<vj
+        if(vi>vj)
+        {
+          swap(vi,vj);
+        }
+        assert(edge2faces.count(EMK(vi,vj))==1);
+        const EMV & neighbors = edge2faces[EMK(vi,vj)];
+        // loop over neighbors
+        for(
+          typename IndexList::const_iterator nit = neighbors.begin();
+          nit != neighbors.end() && !found;
+          nit++)
+        {
+          // index of neighbor in offending (to find its cdt)
+          Index no = offending_index[*nit];
+          // don't consider self or neighbors not numbered yet
+          if(no >= o)
+          {
+            continue;
+          }
+          // Loop over vertices of that neighbor's cdt
+          for(Index u = 0;u<(Index)cdt_points[no].size() && !found;u++)
+          {
+            if(vit_point_3 == cdt_points[no][u])
+            {
+              cdt_index[o][i] = cdt_index[no][u];
+              found = true;
+            }
+          }
+        }
+      }
+      if(!found)
+      {
+        cdt_index[o][i] = V.rows()+NV_count;
+        NV.push_back(vit_point_3);
+        NV_count++;
+      }
+    }
+    for(Index i = 0;i<NF[o].size();i++)
+    {
+      NF[o](i) = cdt_index[o][NF[o](i)];
+    }
+    NF_count+=NF[o].rows();
+  }
+#ifdef IGL_SELFINTERSECTMESH_DEBUG
+  cout<<"Vertex numbering: "<<tictoc()<<endl;
+#endif
 
   assert(NV_count == (Index)NV.size());
   // Build output
@@ -731,11 +864,6 @@ inline void igl::SelfIntersectMesh<
   mark_offensive(fa);
   mark_offensive(fb);
   this->count++;
-  // We found the first intersection
-  if(params.first_only && this->count >= 1)
-  {
-    throw IGL_FIRST_HIT_EXCEPTION;
-  }
 }
 
 template <
@@ -758,8 +886,7 @@ inline bool igl::SelfIntersectMesh<
   DerivedIM>::intersect(
   const Triangle_3 & A, 
   const Triangle_3 & B, 
-  const Index fa,
-  const Index fb)
+  ObjectList & objects) const
 {
   // Determine whether there is an intersection
   if(!CGAL::do_intersect(A,B))
@@ -770,10 +897,8 @@ inline bool igl::SelfIntersectMesh<
   {
     // Construct intersection
     CGAL::Object result = CGAL::intersection(A,B);
-    F_objects[fa].push_back(result);
-    F_objects[fb].push_back(result);
+    objects.push_back(result);
   }
-  count_intersection(fa,fb);
   return true;
 }
 
@@ -797,10 +922,9 @@ inline bool igl::SelfIntersectMesh<
   DerivedIM>::single_shared_vertex(
   const Triangle_3 & A,
   const Triangle_3 & B,
-  const Index fa,
-  const Index fb,
   const Index va,
-  const Index vb)
+  const Index vb,
+  ObjectList & objects) const
 {
   ////using namespace std;
   //CGAL::Object result = CGAL::intersection(A,B);
@@ -816,11 +940,11 @@ inline bool igl::SelfIntersectMesh<
   //  // And point must be at shared vertex
   //  assert(CGAL::object_cast<Point_3>(&result));
   //}
-  if(single_shared_vertex(A,B,fa,fb,va))
+  if(single_shared_vertex(A,B,va,objects))
   {
     return true;
   }
-  return single_shared_vertex(B,A,fb,fa,vb);
+  return single_shared_vertex(B,A,vb,objects);
 }
 
 template <
@@ -843,9 +967,8 @@ inline bool igl::SelfIntersectMesh<
   DerivedIM>::single_shared_vertex(
   const Triangle_3 & A,
   const Triangle_3 & B,
-  const Index fa,
-  const Index fb,
-  const Index va)
+  const Index va,
+  ObjectList & objects) const
 {
   // This was not a good idea. It will not handle coplanar triangles well.
   using namespace std;
@@ -864,19 +987,14 @@ inline bool igl::SelfIntersectMesh<
         CGAL::Object seg = CGAL::make_object(Segment_3(
           A.vertex(va),
           *p));
-        F_objects[fa].push_back(seg);
-        F_objects[fb].push_back(seg);
+        objects.push_back(seg);
       }
-      count_intersection(fa,fb);
       return true;
     }else if(CGAL::object_cast<Segment_3 >(&result))
     {
       //cerr<<REDRUM("Coplanar at: "<<fa<<" & "<<fb<<" (single shared).")<<endl;
       // Must be coplanar
-      if(params.detect_only)
-      {
-        count_intersection(fa,fb);
-      }else
+      if(!params.detect_only)
       {
         // WRONG:
         //// Segment intersection --> triangle from shared point to intersection
@@ -888,7 +1006,7 @@ inline bool igl::SelfIntersectMesh<
         //F_objects[fb].push_back(tri);
         //count_intersection(fa,fb);
         // Need to do full test. Intersection could be a general poly.
-        bool test = intersect(A,B,fa,fb);
+        bool test = intersect(A,B,objects);
         ((void)test);
         assert(test);
       }
@@ -924,8 +1042,7 @@ inline bool igl::SelfIntersectMesh<
   DerivedIM>::double_shared_vertex(
   const Triangle_3 & A,
   const Triangle_3 & B,
-  const Index fa,
-  const Index fb)
+  ObjectList & objects) const
 {
   using namespace std;
   // Cheaper way to do this than calling do_intersect?
@@ -955,10 +1072,8 @@ inline bool igl::SelfIntersectMesh<
           if(!params.detect_only)
           {
             // Triangle object
-            F_objects[fa].push_back(result);
-            F_objects[fb].push_back(result);
+            objects.push_back(result);
           }
-          count_intersection(fa,fb);
           //cerr<<REDRUM("Coplanar at: "<<fa<<" & "<<fb<<" (double shared).")<<endl;
           return true;
         }
@@ -1004,6 +1119,206 @@ inline void igl::SelfIntersectMesh<
   DerivedIM>::box_intersect(
   const Box& a, 
   const Box& b)
+{
+  // index in F
+  const Index fa = *a.handle();
+  const Index fb = *b.handle();
+  if(params.first_only)
+  {
+    // Test right away so that we can stop at the first hit
+    ObjectList objects_a, objects_b;
+    if(filter_pair(fa,fb) && test_pair(fa,fb,objects_a))
+    {
+      // fb gets its own objects (see constructor)
+      if(!params.detect_only)
+      {
+        test_pair(fa,fb,objects_b);
+      }
+      F_objects[fa].insert(
+        F_objects[fa].end(),objects_a.begin(),objects_a.end());
+      F_objects[fb].insert(
+        F_objects[fb].end(),objects_b.begin(),objects_b.end());
+      count_intersection(fa,fb);
+      // We found the first intersection
+      throw IGL_FIRST_HIT_EXCEPTION;
+    }
+    return;
+  }
+  candidates.push_back(std::pair<Index,Index>(fa,fb));
+}
+
+template <
+  typename Kernel,
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedVV,
+  typename DerivedFF,
+  typename DerivedIF,
+  typename DerivedJ,
+  typename DerivedIM>
+inline typename igl::SelfIntersectMesh<
+  Kernel,
+  DerivedV,
+  DerivedF,
+  DerivedVV,
+  DerivedFF,
+  DerivedIF,
+  DerivedJ,
+  DerivedIM>::Triangle_3 
+igl::SelfIntersectMesh<
+  Kernel,
+  DerivedV,
+  DerivedF,
+  DerivedVV,
+  DerivedFF,
+  DerivedIF,
+  DerivedJ,
+  DerivedIM>::face_triangle(const Index f) const
+{
+  // Same construction as mesh_to_cgal_triangle_list
+  return Triangle_3(
+    Point_3( V(F(f,0),0), V(F(f,0),1), V(F(f,0),2)),
+    Point_3( V(F(f,1),0), V(F(f,1),1), V(F(f,1),2)),
+    Point_3( V(F(f,2),0), V(F(f,2),1), V(F(f,2),2)));
+}
+
+template <
+  typename Kernel,
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedVV,
+  typename DerivedFF,
+  typename DerivedIF,
+  typename DerivedJ,
+  typename DerivedIM>
+inline CGAL::Bbox_3 igl::SelfIntersectMesh<
+  Kernel,
+  DerivedV,
+  DerivedF,
+  DerivedVV,
+  DerivedFF,
+  DerivedIF,
+  DerivedJ,
+  DerivedIM>::face_bbox(const Index f) const
+{
+  if(!std::is_floating_point<typename DerivedV::Scalar>::value)
+  {
+    return face_triangle(f).bbox();
+  }
+  double lo[3],hi[3];
+  for(int d = 0;d<3;d++)
+  {
+    lo[d] = hi[d] = (double)V(F(f,0),d);
+    for(int c = 1;c<3;c++)
+    {
+      lo[d] = std::min(lo[d],(double)V(F(f,c),d));
+      hi[d] = std::max(hi[d],(double)V(F(f,c),d));
+    }
+  }
+  return CGAL::Bbox_3(lo[0],lo[1],lo[2],hi[0],hi[1],hi[2]);
+}
+
+template <
+  typename Kernel,
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedVV,
+  typename DerivedFF,
+  typename DerivedIF,
+  typename DerivedJ,
+  typename DerivedIM>
+inline bool igl::SelfIntersectMesh<
+  Kernel,
+  DerivedV,
+  DerivedF,
+  DerivedVV,
+  DerivedFF,
+  DerivedIF,
+  DerivedJ,
+  DerivedIM>::filter_pair(
+  const Index fa,
+  const Index fb) const
+{
+  // Only exact if V is (and nothing to gain if Kernel has the same
+  // predicates)
+  if(!std::is_floating_point<typename DerivedV::Scalar>::value ||
+    std::is_same<Kernel,FilterKernel>::value)
+  {
+    return true;
+  }
+  const auto & point = [this](const Index v)->FilterPoint_3
+  {
+    return FilterPoint_3((double)V(v,0),(double)V(v,1),(double)V(v,2));
+  };
+  const FilterTriangle_3 A(point(F(fa,0)),point(F(fa,1)),point(F(fa,2)));
+  const FilterTriangle_3 B(point(F(fb,0)),point(F(fb,1)),point(F(fb,2)));
+  // Shared vertices, as in test_pair
+  Index total_shared_vertices = 0;
+  Index va=-1,vb=-1;
+  bool b_shared[3] = {false,false,false};
+  for(Index ea=0;ea<3;ea++)
+  {
+    for(Index eb=0;eb<3;eb++)
+    {
+      if(F(fa,ea) == F(fb,eb) || A.vertex(ea) == B.vertex(eb))
+      {
+        total_shared_vertices++;
+        va = ea;
+        vb = eb;
+        b_shared[eb] = true;
+      }
+    }
+  }
+  switch(total_shared_vertices)
+  {
+    case 0:
+      return CGAL::do_intersect(A,B);
+    case 1:
+      // An edge opposite the shared vertex must hit the other triangle
+      return 
+        CGAL::do_intersect(
+          FilterSegment_3(A.vertex((va+1)%3),A.vertex((va+2)%3)),B) ||
+        CGAL::do_intersect(
+          FilterSegment_3(B.vertex((vb+1)%3),B.vertex((vb+2)%3)),A);
+    case 2:
+    {
+      // Must be coplanar (the unshared vertex of B lies on A's plane)
+      Index ub = 0;
+      while(ub<2 && b_shared[ub])
+      {
+        ub++;
+      }
+      return 
+        CGAL::coplanar(A.vertex(0),A.vertex(1),A.vertex(2),B.vertex(ub)) &&
+        CGAL::do_intersect(A,B);
+    }
+    default:
+      // Duplicates
+      return false;
+  }
+}
+
+template <
+  typename Kernel,
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedVV,
+  typename DerivedFF,
+  typename DerivedIF,
+  typename DerivedJ,
+  typename DerivedIM>
+inline bool igl::SelfIntersectMesh<
+  Kernel,
+  DerivedV,
+  DerivedF,
+  DerivedVV,
+  DerivedFF,
+  DerivedIF,
+  DerivedJ,
+  DerivedIM>::test_pair(
+  const Index fa,
+  const Index fb,
+  ObjectList & objects) const
 {
   using namespace std;
   // Could we write this as a static function of:
@@ -1013,15 +1328,13 @@ inline void igl::SelfIntersectMesh<
   // A
   // B
 
-  // index in F and T
-  Index fa = a.handle()-T.begin();
-  Index fb = b.handle()-T.begin();
-  const Triangle_3 & A = *a.handle();
-  const Triangle_3 & B = *b.handle();
+  // Private copies of faces fa and fb
+  const Triangle_3 A = face_triangle(fa);
+  const Triangle_3 B = face_triangle(fb);
   // I'm not going to deal with degenerate triangles, though at some point we
   // should
-  assert(!a.handle()->is_degenerate());
-  assert(!b.handle()->is_degenerate());
+  assert(!A.is_degenerate());
+  assert(!B.is_degenerate());
   // Number of combinatorially shared vertices
   Index comb_shared_vertices = 0;
   // Number of geometrically shared vertices (*not* including combinatorially
@@ -1053,13 +1366,13 @@ inline void igl::SelfIntersectMesh<
   {
     //// Combinatorially duplicate face, these should be removed by preprocessing
     //cerr<<REDRUM("Facets "<<fa<<" and "<<fb<<" are combinatorial duplicates")<<endl;
-    goto done;
+    return false;
   }
   if(total_shared_vertices== 3)
   {
     //// Geometrically duplicate face, these should be removed by preprocessing
     //cerr<<REDRUM("Facets "<<fa<<" and "<<fb<<" are geometrical duplicates")<<endl;
-    goto done;
+    return false;
   }
   //// SPECIAL CASES ARE BROKEN FOR COPLANAR TRIANGLES
   //if(total_shared_vertices > 0)
@@ -1086,9 +1399,7 @@ inline void igl::SelfIntersectMesh<
     // | /\ |
     // |/  \|
     // o----o
-    double_shared_vertex(A,B,fa,fb);
-
-    goto done;
+    return double_shared_vertex(A,B,objects);
   }
   assert(total_shared_vertices<=1);
   if(total_shared_vertices==1)
@@ -1098,7 +1409,7 @@ inline void igl::SelfIntersectMesh<
 //#ifndef NDEBUG
 //    CGAL::Object result =
 //#endif
-    single_shared_vertex(A,B,fa,fb,va,vb);
+    return single_shared_vertex(A,B,va,vb,objects);
 //#ifndef NDEBUG
 //    if(!CGAL::object_cast<Segment_3 >(&result))
 //    {
@@ -1121,10 +1432,8 @@ inline void igl::SelfIntersectMesh<
   {
 //full:
     // No geometrically shared vertices, do general intersect
-    intersect(*a.handle(),*b.handle(),fa,fb);
+    return intersect(A,B,objects);
   }
-done:
-  return;
 }
 
 // Compute 2D delaunay triangulation of a given 3d triangle and a list of
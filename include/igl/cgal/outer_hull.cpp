@@ -8,19 +8,13 @@
 #include "outer_hull.h"
 #include "order_facets_around_edges.h"
 #include "../outer_facet.h"
-#include "../sortrows.h"
-#include "../facet_components.h"
 #include "../winding_number.h"
-#include "../triangle_triangle_adjacency.h"
 #include "../unique_edge_map.h"
-#include "../barycenter.h"
 #include "../per_face_normals.h"
-#include "../writePLY.h"
-#include "../sort_angles.h"
 
 #include <Eigen/Geometry>
+#include <algorithm>
 #include <vector>
-#include <map>
 #include <queue>
 #include <iostream>
 #include <type_traits>
@@ -31,6 +25,10 @@ template <
   typename DerivedV,
   typename DerivedF,
   typename DerivedN,
+  typename DerivedEMAP,
+  typename uE2oEType,
+  typename uE2CType,
+  typename DerivedI,
   typename DerivedG,
   typename DerivedJ,
   typename Derivedflip>
@@ -38,6 +36,10 @@ IGL_INLINE void igl::outer_hull(
   const Eigen::PlainObjectBase<DerivedV> & V,
   const Eigen::PlainObjectBase<DerivedF> & F,
   const Eigen::PlainObjectBase<DerivedN> & N,
+  const Eigen::PlainObjectBase<DerivedEMAP> & EMAP,
+  const std::vector<std::vector<uE2oEType> > & uE2oE,
+  const std::vector<std::vector<uE2CType> > & uE2C,
+  const Eigen::PlainObjectBase<DerivedI> & I,
   Eigen::PlainObjectBase<DerivedG> & G,
   Eigen::PlainObjectBase<DerivedJ> & J,
   Eigen::PlainObjectBase<Derivedflip> & flip)
@@ -47,126 +49,119 @@ IGL_INLINE void igl::outer_hull(
 #endif
   using namespace Eigen;
   using namespace std;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
   typedef typename DerivedF::Index Index;
-  Matrix<Index,DerivedF::RowsAtCompileTime,1> C;
-  typedef Matrix<typename DerivedV::Scalar,Dynamic,DerivedV::ColsAtCompileTime> MatrixXV;
-  typedef Matrix<typename DerivedF::Scalar,Dynamic,DerivedF::ColsAtCompileTime> MatrixXF;
   typedef Matrix<typename DerivedG::Scalar,Dynamic,DerivedG::ColsAtCompileTime> MatrixXG;
   typedef Matrix<typename DerivedJ::Scalar,Dynamic,DerivedJ::ColsAtCompileTime> MatrixXJ;
-  typedef Matrix<typename DerivedN::Scalar,1,3> RowVector3N;
+  typedef Matrix<Index,Dynamic,1> VectorXI;
   const Index m = F.rows();
+  const Index mi = I.size();
+  flip.setConstant(m,1,false);
 
-  // UNUSED:
-  //const auto & duplicate_simplex = [&F](const int f, const int g)->bool
-  //{
-  //  return
-  //    (F(f,0) == F(g,0) && F(f,1) == F(g,1) && F(f,2) == F(g,2)) ||
-  //    (F(f,1) == F(g,0) && F(f,2) == F(g,1) && F(f,0) == F(g,2)) ||
-  //    (F(f,2) == F(g,0) && F(f,0) == F(g,1) && F(f,1) == F(g,2)) ||
-  //    (F(f,0) == F(g,2) && F(f,1) == F(g,1) && F(f,2) == F(g,0)) ||
-  //    (F(f,1) == F(g,2) && F(f,2) == F(g,1) && F(f,0) == F(g,0)) ||
-  //    (F(f,2) == F(g,2) && F(f,0) == F(g,1) && F(f,1) == F(g,0));
-  //};
-
-#ifdef IGL_OUTER_HULL_DEBUG
-  cout<<"outer hull..."<<endl;
-#endif
-
-#ifdef IGL_OUTER_HULL_DEBUG
-  cout<<"edge map..."<<endl;
-#endif
-  typedef Matrix<typename DerivedF::Scalar,Dynamic,2> MatrixX2I;
-  typedef Matrix<typename DerivedF::Index,Dynamic,1> VectorXI;
-  typedef Matrix<typename DerivedV::Scalar, 3, 1> Vector3F;
-  MatrixX2I E,uE;
-  VectorXI EMAP;
-  vector<vector<typename DerivedF::Index> > uE2E;
-  unique_edge_map(F,E,uE,EMAP,uE2E);
-#ifdef IGL_OUTER_HULL_DEBUG
-  for (size_t ui=0; ui<uE.rows(); ui++) {
-      std::cout << ui << ": " << uE2E[ui].size() << " -- (";
-      for (size_t i=0; i<uE2E[ui].size(); i++) {
-          std::cout << uE2E[ui][i] << ", ";
-      }
-      std::cout << ")" << std::endl;
+  // Facets under consideration and position of each of their face-edges in
+  // the ordering around its unique edge
+  vector<char> active(m,0);
+  for(Index i = 0;i<mi;i++)
+  {
+    active[I(i)] = 1;
   }
-#endif
-
-  std::vector<std::vector<typename DerivedF::Index> > uE2oE;
-  std::vector<std::vector<bool> > uE2C;
-  order_facets_around_edges(V, F, N, E, uE, EMAP, uE2E, uE2oE, uE2C);
-  uE2E = uE2oE;
-  VectorXI diIM(3*m);
-  for (auto ue : uE2E) {
-      for (size_t i=0; i<ue.size(); i++) {
-          auto fe = ue[i];
-          diIM[fe] = i;
-      }
+  vector<Index> diIM(3*m,-1);
+#pragma omp parallel for if (mi>IGL_OMP_MIN_VALUE)
+  for(Index i = 0;i<mi;i++)
+  {
+    for(Index c = 0;c<3;c++)
+    {
+      const Index e = I(i)+c*m;
+      const auto & ue = uE2oE[EMAP(e)];
+      diIM[e] = find(ue.begin(),ue.end(),e)-ue.begin();
+    }
   }
 
-  vector<vector<vector<Index > > > TT,_1;
-  triangle_triangle_adjacency(E,EMAP,uE2E,false,TT,_1);
-  VectorXI counts;
 #ifdef IGL_OUTER_HULL_DEBUG
   cout<<"facet components..."<<endl;
 #endif
-  facet_components(TT,C,counts);
-  assert(C.maxCoeff()+1 == counts.rows());
-  const size_t ncc = counts.rows();
-  G.resize(0,F.cols());
-  J.resize(0,1);
-  flip.setConstant(m,1,false);
-
-#ifdef IGL_OUTER_HULL_DEBUG
-  cout<<"reindex..."<<endl;
-#endif
-  // H contains list of faces on outer hull;
-  vector<bool> FH(m,false);
-  vector<bool> EH(3*m,false);
-  vector<MatrixXG> vG(ncc);
-  vector<MatrixXJ> vJ(ncc);
-  vector<MatrixXJ> vIM(ncc);
-  //size_t face_count = 0;
+  // Components of considered facets (connected across any shared edge),
+  // numbered in order of their smallest facet like facet_components
+  vector<Index> C(m,-1);
+  vector<Index> counts;
+  {
+    vector<Index> stack;
+    for(Index i = 0;i<mi;i++)
+    {
+      if(C[I(i)] >= 0)
+      {
+        continue;
+      }
+      const Index id = counts.size();
+      counts.push_back(0);
+      C[I(i)] = id;
+      stack.push_back(I(i));
+      while(!stack.empty())
+      {
+        const Index f = stack.back();
+        stack.pop_back();
+        counts[id]++;
+        for(Index c = 0;c<3;c++)
+        {
+          for(const auto & ne : uE2oE[EMAP(f+c*m)])
+          {
+            const Index nf = ne%m;
+            if(active[nf] && C[nf] < 0)
+            {
+              C[nf] = id;
+              stack.push_back(nf);
+            }
+          }
+        }
+      }
+    }
+  }
+  const size_t ncc = counts.size();
+  vector<VectorXI> vIM(ncc);
   for(size_t id = 0;id<ncc;id++)
   {
     vIM[id].resize(counts[id],1);
   }
-  // current index into each IM
-  vector<size_t> g(ncc,0);
-  // place order of each face in its respective component
-  for(Index f = 0;f<m;f++)
   {
-    vIM[C(f)](g[C(f)]++) = f;
+    // current index into each IM
+    vector<Index> g(ncc,0);
+    for(Index i = 0;i<mi;i++)
+    {
+      vIM[C[I(i)]](g[C[I(i)]]++) = I(i);
+    }
   }
 
 #ifdef IGL_OUTER_HULL_DEBUG
-  cout<<"barycenters..."<<endl;
-#endif
-  // assumes that "resolve" has handled any coplanar cases correctly and nearly
-  // coplanar cases can be sorted based on barycenter.
-  MatrixXV BC;
-  barycenter(V,F,BC);
-
-#ifdef IGL_OUTER_HULL_DEBUG
-  cout<<"loop over CCs (="<<ncc<<")..."<<endl;
+  cout<<"outer facets..."<<endl;
 #endif
-  for(Index id = 0;id<(Index)ncc;id++)
+  // Starting face that's guaranteed to be on the outer hull of each
+  // component. This compares (possibly lazy exact) coordinates so it stays
+  // serial.
+  vector<int> seed(ncc);
+  vector<char> seed_flip(ncc);
+  for(size_t id = 0;id<ncc;id++)
   {
-    auto & IM = vIM[id];
-    // starting face that's guaranteed to be on the outer hull and in this
-    // component
-    int f;
     bool f_flip;
+    outer_facet(V,F,N,vIM[id],seed[id],f_flip);
+    seed_flip[id] = f_flip;
+  }
+
 #ifdef IGL_OUTER_HULL_DEBUG
-  cout<<"outer facet..."<<endl;
-#endif
-    outer_facet(V,F,N,IM,f,f_flip);
-#ifdef IGL_OUTER_HULL_DEBUG
-  cout<<"outer facet: "<<f<<endl;
-  cout << V.row(F(f, 0)) << std::endl;
-  cout << V.row(F(f, 1)) << std::endl;
-  cout << V.row(F(f, 2)) << std::endl;
+  cout<<"BFS over CCs (="<<ncc<<")..."<<endl;
 #endif
+  // Components only touch their own facets (and face-edges) so they are
+  // traversed in parallel
+  vector<char> FH(m,0);
+  vector<char> EH(3*m,0);
+  vector<MatrixXG> vG(ncc);
+  vector<MatrixXJ> vJ(ncc);
+#pragma omp parallel for schedule(dynamic) if (mi>IGL_OMP_MIN_VALUE)
+  for(int id = 0;id<(int)ncc;id++)
+  {
+    const auto & IM = vIM[id];
+    const int f = seed[id];
     int FHcount = 1;
     FH[f] = true;
     // Q contains list of face edges to continue traversing upong
@@ -174,13 +169,7 @@ IGL_INLINE void igl::outer_hull(
     Q.push(f+0*m);
     Q.push(f+1*m);
     Q.push(f+2*m);
-    flip(f) = f_flip;
-    //std::cout << "face " << face_count++ << ": " << f << std::endl;
-    //std::cout << "f " << F.row(f).array()+1 << std::endl;
-    //cout<<"flip("<<f<<") = "<<(flip(f)?"true":"false")<<endl;
-#ifdef IGL_OUTER_HULL_DEBUG
-  cout<<"BFS..."<<endl;
-#endif
+    flip(f) = seed_flip[id];
     while(!Q.empty())
     {
       // face-edge
@@ -190,12 +179,6 @@ IGL_INLINE void igl::outer_hull(
       const int f = e%m;
       // corner
       const int c = e/m;
-#ifdef IGL_OUTER_HULL_DEBUG
-      std::cout << "edge: " << e << ", ue: " << EMAP(e) << std::endl;
-      std::cout << "face: " << f << std::endl;
-      std::cout << "corner: " << c << std::endl;
-      std::cout << "consistent: " << uE2C[EMAP(e)][diIM[e]] << std::endl;
-#endif
       // Should never see edge again...
       if(EH[e] == true)
       {
@@ -206,165 +189,46 @@ IGL_INLINE void igl::outer_hull(
       const int fs = flip(f)?F(f,(c+2)%3):F(f,(c+1)%3);
       // destination of edge according to f
       const int fd = flip(f)?F(f,(c+1)%3):F(f,(c+2)%3);
+      // facets around edge in order
+      const auto & ue = uE2oE[EMAP(e)];
       // edge valence
-      const size_t val = uE2E[EMAP(e)].size();
-#ifdef IGL_OUTER_HULL_DEBUG
-      std::cout << "vd: " << V.row(fd) << std::endl;
-      std::cout << "vs: " << V.row(fs) << std::endl;
-      std::cout << "edge: " << V.row(fd) - V.row(fs) << std::endl;
-      for (size_t i=0; i<val; i++) {
-          if (i == diIM(e)) {
-              std::cout << "* ";
-          } else {
-              std::cout << "  ";
-          }
-          std::cout << i << ": "
-              << " (e: " << uE2E[EMAP(e)][i] << ", f: "
-              << uE2E[EMAP(e)][i] % m * (uE2C[EMAP(e)][i] ? 1:-1) << ")" << std::endl;
-      }
-#endif
-      //// find overlapping face-edges
-      //const auto & neighbors = uE2E[EMAP(e)];
-      //// normal after possible flipping
-      //const auto & fN = (flip(f)?-1.:1.)*N.row(f);
-      //// Edge vector according to f's (flipped) orientation.
-      ////const auto & eV = (V.row(fd)-V.row(fs)).normalized();
-
-//#warning "EXPERIMENTAL, DO NOT USE"
-      //// THIS IS WRONG! The first face is---after sorting---no longer the face
-      //// used for orienting the sort.
-      //const auto ui = EMAP(e);
-      //const auto fe0 = uE2E[ui][0];
-      //const auto es = F(fe0%m,((fe0/m)+1)%3);
-
+      const size_t val = ue.size();
       // is edge consistent with edge of face used for sorting
-      const int e_cons = (uE2C[EMAP(e)][diIM(e)] ? 1: -1);
+      const int e_cons = (uE2C[EMAP(e)][diIM[e]] ? 1: -1);
       int nfei = -1;
-      // Loop once around trying to find suitable next face
+      // Loop once around trying to find suitable next face, facets not under
+      // consideration are skipped as if they were not there
       for(size_t step = 1; step<val+2;step++)
       {
-        const int nfei_new = (diIM(e) + 2*val + e_cons*step*(flip(f)?-1:1))%val;
-        const int nf = uE2E[EMAP(e)][nfei_new] % m;
-        // Don't consider faces with identical dihedral angles
-        //if ((di[EMAP(e)][diIM(e)].array() != di[EMAP(e)][nfei_new].array()).any())
-        //if((di[EMAP(e)][diIM(e)] != di[EMAP(e)][nfei_new]))
-//#warning "THIS IS HACK, FIX ME"
-//        if( abs(di[EMAP(e)][diIM(e)] - di[EMAP(e)][nfei_new]) < 1e-15 )
+        const int nfei_new = (diIM[e] + 2*val + e_cons*step*(flip(f)?-1:1))%val;
+        const int nf = ue[nfei_new] % m;
+        if(!active[nf])
         {
-#ifdef IGL_OUTER_HULL_DEBUG
-        //cout<<"Next facet: "<<(f+1)<<" --> "<<(nf+1)<<", |"<<
-        //  di[EMAP(e)][diIM(e)]<<" - "<<di[EMAP(e)][nfei_new]<<"| = "<<
-        //    abs(di[EMAP(e)][diIM(e)] - di[EMAP(e)][nfei_new])
-        //    <<endl;
-#endif
-
-
-
-          // Only use this face if not already seen
-          if(!FH[nf])
-          {
-            nfei = nfei_new;
-          //} else {
-          //    std::cout << "skipping face " << nfei_new << " because it is seen before"
-          //        << std::endl;
-          }
-          break;
-        //} else {
-        //    std::cout << di[EMAP(e)][diIM(e)].transpose() << std::endl;
-        //    std::cout << di[EMAP(e)][diIM(nfei_new)].transpose() << std::endl;
-        //    std::cout << "skipping face " << nfei_new << " with identical dihedral angle"
-        //        << std::endl;
+          continue;
         }
-//#ifdef IGL_OUTER_HULL_DEBUG
-//        cout<<"Skipping co-planar facet: "<<(f+1)<<" --> "<<(nf+1)<<endl;
-//#endif
+        // Only use this face if not already seen
+        if(!FH[nf])
+        {
+          nfei = nfei_new;
+        }
+        break;
       }
 
-      int max_ne = -1;
-      //// Loop over and find max dihedral angle
-      //typename DerivedV::Scalar max_di = -1;
-      //for(const auto & ne : neighbors)
-      //{
-      //  const int nf = ne%m;
-      //  if(nf == f)
-      //  {
-      //    continue;
-      //  }
-      //  // Corner of neighbor
-      //  const int nc = ne/m;
-      //  // Is neighbor oriented consistently with (flipped) f?
-      //  //const int ns = F(nf,(nc+1)%3);
-      //  const int nd = F(nf,(nc+2)%3);
-      //  const bool cons = (flip(f)?fd:fs) == nd;
-      //  // Normal after possibly flipping to match flip or orientation of f
-      //  const auto & nN = (cons? (flip(f)?-1:1.) : (flip(f)?1.:-1.) )*N.row(nf);
-      //  // Angle between n and f
-      //  const auto & ndi = M_PI - atan2( fN.cross(nN).dot(eV), fN.dot(nN));
-      //  if(ndi>=max_di)
-      //  {
-      //    max_ne = ne;
-      //    max_di = ndi;
-      //  }
-      //}
-
-      ////cout<<(max_ne != max_ne_2)<<" =?= "<<e_cons<<endl;
-      //if(max_ne != max_ne_2)
-      //{
-      //  cout<<(f+1)<<" ---> "<<(max_ne%m)+1<<" != "<<(max_ne_2%m)+1<<" ... "<<e_cons<<" "<<flip(f)<<endl;
-      //  typename DerivedV::Scalar max_di = -1;
-      //  for(size_t nei = 0;nei<neighbors.size();nei++)
-      //  {
-      //    const auto & ne = neighbors[nei];
-      //    const int nf = ne%m;
-      //    if(nf == f)
-      //    {
-      //      cout<<"  "<<(ne%m)+1<<":\t"<<0<<"\t"<<di[EMAP[e]][nei]<<" "<<diIM(ne)<<endl;
-      //      continue;
-      //    }
-      //    // Corner of neighbor
-      //    const int nc = ne/m;
-      //    // Is neighbor oriented consistently with (flipped) f?
-      //    //const int ns = F(nf,(nc+1)%3);
-      //    const int nd = F(nf,(nc+2)%3);
-      //    const bool cons = (flip(f)?fd:fs) == nd;
-      //    // Normal after possibly flipping to match flip or orientation of f
-      //    const auto & nN = (cons? (flip(f)?-1:1.) : (flip(f)?1.:-1.) )*N.row(nf);
-      //    // Angle between n and f
-      //    const auto & ndi = M_PI - atan2( fN.cross(nN).dot(eV), fN.dot(nN));
-      //    cout<<"  "<<(ne%m)+1<<":\t"<<ndi<<"\t"<<di[EMAP[e]][nei]<<" "<<diIM(ne)<<endl;
-      //    if(ndi>=max_di)
-      //    {
-      //      max_ne = ne;
-      //      max_di = ndi;
-      //    }
-      //  }
-      //}
       if(nfei >= 0)
       {
-        max_ne = uE2E[EMAP(e)][nfei];
-      }
-
-      if(max_ne>=0)
-      {
+        const int max_ne = ue[nfei];
         // face of neighbor
         const int nf = max_ne%m;
 #ifdef IGL_OUTER_HULL_DEBUG
-        if(!FH[nf])
-        {
-          // first time seeing face
-          cout<<(f+1)<<" --> "<<(nf+1)<<endl;
-        }
+        cout<<(f+1)<<" --> "<<(nf+1)<<endl;
 #endif
         FH[nf] = true;
-        //std::cout << "face " << face_count++ << ": " << nf << std::endl;
-        //std::cout << "f " << F.row(nf).array()+1 << std::endl;
         FHcount++;
         // corner of neighbor
         const int nc = max_ne/m;
         const int nd = F(nf,(nc+2)%3);
         const bool cons = (flip(f)?fd:fs) == nd;
         flip(nf) = (cons ? flip(f) : !flip(f));
-        //cout<<"flip("<<nf<<") = "<<(flip(nf)?"true":"false")<<endl;
         const int ne1 = nf+((nc+1)%3)*m;
         const int ne2 = nf+((nc+2)%3)*m;
         if(!EH[ne1])
@@ -381,16 +245,10 @@ IGL_INLINE void igl::outer_hull(
     {
       vG[id].resize(FHcount,3);
       vJ[id].resize(FHcount,1);
-      //nG += FHcount;
       size_t h = 0;
-      assert(counts(id) == IM.rows());
-      for(int i = 0;i<counts(id);i++)
+      for(int i = 0;i<IM.rows();i++)
       {
         const size_t f = IM(i);
-        //if(f_flip)
-        //{
-        //  flip(f) = !flip(f);
-        //}
         if(FH[f])
         {
           vG[id].row(h) = (flip(f)?F.row(f).reverse().eval():F.row(f));
@@ -402,42 +260,49 @@ IGL_INLINE void igl::outer_hull(
     }
   }
 
-  // Is A inside B? Assuming A and B are consistently oriented but closed and
-  // non-intersecting.
-  const auto & is_component_inside_other = [](
-    const Eigen::MatrixXd & V,
-    const MatrixXV & BC,
-    const MatrixXG & A,
-    const MatrixXJ & AJ,
-    const MatrixXG & B)->bool
+  Eigen::MatrixXd Vcol(V.rows(), V.cols());
+  for (size_t i=0; i<(size_t)V.rows(); i++) {
+      for (size_t j=0; j<(size_t)V.cols(); j++) {
+          Vcol(i, j) = CGAL::to_double(V(i, j));
+      }
+  }
+
+  // Per component bounding box and query point (barycenter of its first hull
+  // facet, computed as in barycenter before rounding)
+  Eigen::MatrixXd BB(ncc,6);
+  Eigen::MatrixXd BC(ncc,3);
+  for(size_t id = 0;id<ncc;id++)
   {
-    const auto & bounding_box = [](
-      const Eigen::MatrixXd & V,
-      const MatrixXG & F)->
-      Eigen::MatrixXd
+    BB.row(id)<<
+       1e26,1e26,1e26,
+      -1e26,-1e26,-1e26;
+    for(Index f = 0;f<vG[id].rows();f++)
     {
-      Eigen::MatrixXd BB(2,3);
-      BB<<
-         1e26,1e26,1e26,
-        -1e26,-1e26,-1e26;
-      const size_t m = F.rows();
-      for(size_t f = 0;f<m;f++)
+      for(Index c = 0;c<3;c++)
       {
-        for(size_t c = 0;c<3;c++)
-        {
-          const auto & vfc = V.row(F(f,c));
-          BB.row(0) = BB.row(0).array().min(vfc.array()).eval();
-          BB.row(1) = BB.row(1).array().max(vfc.array()).eval();
-        }
+        const auto & vfc = Vcol.row(vG[id](f,c));
+        BB.block(id,0,1,3) = BB.block(id,0,1,3).array().min(vfc.array()).eval();
+        BB.block(id,3,1,3) = BB.block(id,3,1,3).array().max(vfc.array()).eval();
       }
-      return BB;
-    };
+    }
+    const Index f = vJ[id](0);
+    for(Index d = 0;d<3;d++)
+    {
+      BC(id,d) = CGAL::to_double(
+        (V(F(f,0),d) + V(F(f,1),d) + V(F(f,2),d))/3.);
+    }
+  }
+
+  // Is A inside B? Assuming A and B are consistently oriented but closed and
+  // non-intersecting.
+  const auto & is_component_inside_other = [&](
+    const size_t a,
+    const size_t b)->bool
+  {
     // A lot of the time we're dealing with unrelated, distant components: cull
     // them.
-    Eigen::MatrixXd ABB = bounding_box(V,A);
-    Eigen::MatrixXd BBB = bounding_box(V,B);
-    if( (BBB.row(0)-ABB.row(1)).maxCoeff()>0  ||
-        (ABB.row(0)-BBB.row(1)).maxCoeff()>0 )
+    if( (BB.block(b,0,1,3)-BB.block(a,3,1,3)).maxCoeff()>0  ||
+        (BB.block(a,0,1,3)-BB.block(b,3,1,3)).maxCoeff()>0 )
     {
       // bounding boxes do not overlap
       return false;
@@ -451,44 +316,34 @@ IGL_INLINE void igl::outer_hull(
     // q could be so close (<~1e-15) to B that the winding number is not a robust way to
     // determine inside/outsideness. We could try to find a _better_ q which is
     // farther away, but couldn't they all be bad?
-    double q[3] = {
-        CGAL::to_double(BC(AJ(0), 0)),
-        CGAL::to_double(BC(AJ(0), 1)),
-        CGAL::to_double(BC(AJ(0), 2)) };
+    double q[3] = { BC(a,0), BC(a,1), BC(a,2) };
     // In a perfect world, it's enough to test a single point.
     double w;
     winding_number_3(
-      V.data(),V.rows(),
-      B.data(),B.rows(),
+      Vcol.data(),Vcol.rows(),
+      vG[b].data(),vG[b].rows(),
       q,1,&w);
     return w > 0.5 || w < -0.5;
   };
 
-  Eigen::MatrixXd Vcol(V.rows(), V.cols());
-  for (size_t i=0; i<(size_t)V.rows(); i++) {
-      for (size_t j=0; j<(size_t)V.cols(); j++) {
-          Vcol(i, j) = CGAL::to_double(V(i, j));
-      }
-  }
-
   // Reject components which are completely inside other components
-  vector<bool> keep(ncc,true);
-  size_t nG = 0;
+  vector<char> keep(ncc,true);
   // This is O( ncc * ncc * m)
-  for(size_t id = 0;id<ncc;id++)
+#pragma omp parallel for schedule(dynamic) if (mi>IGL_OMP_MIN_VALUE)
+  for(int id = 0;id<(int)ncc;id++)
   {
-    for(size_t oid = 0;oid<ncc;oid++)
+    for(size_t oid = 0;oid<ncc && keep[id];oid++)
     {
-      if(id == oid)
+      if((size_t)id == oid)
       {
         continue;
       }
-      const bool inside = is_component_inside_other(Vcol,BC,vG[id],vJ[id],vG[oid]);
-#ifdef IGL_OUTER_HULL_DEBUG
-      cout<<id<<" is inside "<<oid<<" ? "<<inside<<endl;
-#endif
-      keep[id] = keep[id] && !inside;
+      keep[id] = !is_component_inside_other(id,oid);
     }
+  }
+  size_t nG = 0;
+  for(size_t id = 0;id<ncc;id++)
+  {
     if(keep[id])
     {
       nG += vJ[id].rows();
@@ -513,6 +368,37 @@ IGL_INLINE void igl::outer_hull(
   }
 }
 
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedN,
+  typename DerivedG,
+  typename DerivedJ,
+  typename Derivedflip>
+IGL_INLINE void igl::outer_hull(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const Eigen::PlainObjectBase<DerivedN> & N,
+  Eigen::PlainObjectBase<DerivedG> & G,
+  Eigen::PlainObjectBase<DerivedJ> & J,
+  Eigen::PlainObjectBase<Derivedflip> & flip)
+{
+  using namespace Eigen;
+  using namespace std;
+  typedef typename DerivedF::Index Index;
+  typedef Matrix<typename DerivedF::Scalar,Dynamic,2> MatrixX2I;
+  typedef Matrix<Index,Dynamic,1> VectorXI;
+  const Index m = F.rows();
+  MatrixX2I E,uE;
+  VectorXI EMAP;
+  vector<vector<Index> > uE2E,uE2oE;
+  vector<vector<bool> > uE2C;
+  unique_edge_map(F,E,uE,EMAP,uE2E);
+  order_facets_around_edges(V,F,N,E,uE,EMAP,uE2E,uE2oE,uE2C);
+  const VectorXI I = VectorXI::LinSpaced(m,0,m-1);
+  return outer_hull(V,F,N,EMAP,uE2oE,uE2C,I,G,J,flip);
+}
+
 template <
   typename DerivedV,
   typename DerivedF,
@@ -535,7 +421,6 @@ IGL_INLINE void igl::outer_hull(
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template specialization
 #undef IGL_STATIC_LIBRARY
-#include <igl/barycenter.cpp>
 #include <igl/outer_facet.cpp>
 #include <igl/cgal/order_facets_around_edges.cpp>
 #define IGL_STATIC_LIBRARY
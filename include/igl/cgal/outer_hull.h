@@ -9,6 +9,7 @@
 #define IGL_OUTER_HULL_H
 #include "../igl_inline.h"
 #include <Eigen/Core>
+#include <vector>
 namespace igl
 {
   // Compute the "outer hull" of a potentially non-manifold mesh (V,F) whose
@@ -43,6 +44,49 @@ namespace igl
     Eigen::PlainObjectBase<DerivedG> & G,
     Eigen::PlainObjectBase<DerivedJ> & J,
     Eigen::PlainObjectBase<Derivedflip> & flip);
+  // Outer hull of the subset I of facets of (V,F) reusing precomputed edge
+  // connectivity and orderings of facets around edges, so that these can be
+  // computed once for F and shared by several calls (see
+  // peel_outer_hull_layers). Facets not in I are treated as if absent.
+  // Independent components are traversed in parallel.
+  //
+  // Inputs:
+  //   V  #V by 3 list of vertex positions
+  //   F  #F by 3 list of triangle indices into V
+  //   N  #F by 3 list of per-face normals
+  //   EMAP  #F*3 list of indices into uE (see unique_edge_map)
+  //   uE2oE  #uE list of lists of face-edges ordered around each unique edge
+  //     (see order_facets_around_edges)
+  //   uE2C  #uE list of lists of whether each face-edge in uE2oE is
+  //     consistently oriented with the ordering
+  //   I  #I list of (increasing) indices into F of facets to consider
+  // Outputs:
+  //   G  #G by 3 list of output triangle indices into V
+  //   J  #G list of indices into F
+  //   flip  #F list of whether facet was added to G **and** flipped
+  //     orientation (false for faces not added to G)
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedN,
+    typename DerivedEMAP,
+    typename uE2oEType,
+    typename uE2CType,
+    typename DerivedI,
+    typename DerivedG,
+    typename DerivedJ,
+    typename Derivedflip>
+  IGL_INLINE void outer_hull(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const Eigen::PlainObjectBase<DerivedN> & N,
+    const Eigen::PlainObjectBase<DerivedEMAP> & EMAP,
+    const std::vector<std::vector<uE2oEType> > & uE2oE,
+    const std::vector<std::vector<uE2CType> > & uE2C,
+    const Eigen::PlainObjectBase<DerivedI> & I,
+    Eigen::PlainObjectBase<DerivedG> & G,
+    Eigen::PlainObjectBase<DerivedJ> & J,
+    Eigen::PlainObjectBase<Derivedflip> & flip);
   template <
     typename DerivedV,
     typename DerivedF,
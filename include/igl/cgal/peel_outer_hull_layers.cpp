@@ -7,13 +7,14 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "peel_outer_hull_layers.h"
 #include "../per_face_normals.h"
+#include "../unique_edge_map.h"
+#include "order_facets_around_edges.h"
 #include "outer_hull.h"
 #include <vector>
 #include <iostream>
 //#define IGL_PEEL_OUTER_HULL_LAYERS_DEBUG
 #ifdef IGL_PEEL_OUTER_HULL_LAYERS_DEBUG
 #include "../writePLY.h"
-#include "../writeDMAT.h"
 #include "../STR.h"
 #endif
 
@@ -35,79 +36,70 @@ IGL_INLINE size_t igl::peel_outer_hull_layers(
   using namespace std;
   typedef typename DerivedF::Index Index;
   typedef Matrix<typename DerivedF::Scalar,Dynamic,DerivedF::ColsAtCompileTime> MatrixXF;
-  typedef Matrix<typename DerivedN::Scalar,Dynamic,DerivedN::ColsAtCompileTime> MatrixXN;
+  typedef Matrix<typename DerivedF::Scalar,Dynamic,2> MatrixX2I;
   typedef Matrix<Index,Dynamic,1> MatrixXI;
   typedef Matrix<typename Derivedflip::Scalar,Dynamic,Derivedflip::ColsAtCompileTime> MatrixXflip;
   const Index m = F.rows();
 #ifdef IGL_PEEL_OUTER_HULL_LAYERS_DEBUG
   cout<<"peel outer hull layers..."<<endl;
-#endif
-#ifdef IGL_PEEL_OUTER_HULL_LAYERS_DEBUG
-  cout<<"calling outer hull..."<<endl;
   writePLY(STR("peel-outer-hull-input.ply"),V,F);
 #endif
 
+  // Edge connectivity and the ordering of facets around each edge do not
+  // change as layers are peeled away: removing facets only removes them from
+  // each ordering. So compute them once and have outer_hull skip facets
+  // already peeled.
+  MatrixX2I E,uE;
+  MatrixXI EMAP;
+  vector<vector<Index> > uE2E,uE2oE;
+  vector<vector<bool> > uE2C;
+  unique_edge_map(F,E,uE,EMAP,uE2E);
+  order_facets_around_edges(V,F,N,E,uE,EMAP,uE2E,uE2oE,uE2C);
+
 #ifdef IGL_PEEL_OUTER_HULL_LAYERS_DEBUG
   cout<<"resize output ..."<<endl;
 #endif
   // keep track of iteration parity and whether flipped in hull
-  MatrixXF Fr = F;
-  MatrixXN Nr = N;
   odd.resize(m,1);
   flip.resize(m,1);
-  // Keep track of index map
+  // Remaining facets (in increasing order)
   MatrixXI IM = MatrixXI::LinSpaced(m,0,m-1);
+  vector<bool> peeled(m,false);
   // This is O(n * layers)
   bool odd_iter = true;
-  MatrixXI P(m,1);
   Index iter = 0;
-  while(Fr.size() > 0)
+  while(IM.size() > 0)
   {
-    assert(Fr.rows() == IM.rows());
-    // Compute outer hull of current Fr
+    // Compute outer hull of remaining facets
     MatrixXF Fo;
     MatrixXI Jo;
     MatrixXflip flipr;
 #ifdef IGL_PEEL_OUTER_HULL_LAYERS_DEBUG
   cout<<"calling outer hull..."<<endl;
-  writePLY(STR("outer-hull-input-"<<iter<<".ply"),V,Fr);
-  writeDMAT(STR("outer-hull-input-"<<iter<<".dmat"),Nr);
 #endif
-    outer_hull(V,Fr,Nr,Fo,Jo,flipr);
+    outer_hull(V,F,N,EMAP,uE2oE,uE2C,IM,Fo,Jo,flipr);
 #ifdef IGL_PEEL_OUTER_HULL_LAYERS_DEBUG
   writePLY(STR("outer-hull-output-"<<iter<<".ply"),V,Fo);
   cout<<"reindex, flip..."<<endl;
 #endif
     assert(Fo.rows() == Jo.rows());
-    // all faces in Fo of Fr
-    vector<bool> in_outer(Fr.rows(),false);
     for(Index g = 0;g<Jo.rows();g++)
     {
-      odd(IM(Jo(g))) = odd_iter;
-      P(IM(Jo(g))) = iter;
-      in_outer[Jo(g)] = true;
-      flip(IM(Jo(g))) = flipr(Jo(g));
+      odd(Jo(g)) = odd_iter;
+      peeled[Jo(g)] = true;
+      flip(Jo(g)) = flipr(Jo(g));
     }
-    // Fr = Fr - Fo
-    // update IM
-    MatrixXF prev_Fr = Fr;
-    MatrixXN prev_Nr = Nr;
-    MatrixXI prev_IM = IM;
-    Fr.resize(prev_Fr.rows() - Fo.rows(),F.cols());
-    Nr.resize(Fr.rows(),3);
-    IM.resize(Fr.rows());
+    // IM = IM - Jo
     {
       Index g = 0;
-      for(Index f = 0;f<prev_Fr.rows();f++)
+      for(Index i = 0;i<IM.size();i++)
       {
-        if(!in_outer[f])
+        if(!peeled[IM(i)])
         {
-          Fr.row(g) = prev_Fr.row(f);
-          Nr.row(g) = prev_Nr.row(f);
-          IM(g) = prev_IM(f);
-          g++;
+          IM(g++) = IM(i);
         }
       }
+      IM.conservativeResize(g);
     }
     odd_iter = !odd_iter;
     iter++;
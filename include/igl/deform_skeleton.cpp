@@ -39,20 +39,19 @@ IGL_INLINE void igl::deform_skeleton(
   Eigen::MatrixXi & BET)
 {
   using namespace Eigen;
-  //assert(BE.rows() == (int)vA.size());
-  CT.resize(2*BE.rows(),C.cols());
+  assert(T.rows() == BE.rows()*4);
+  assert(T.cols() % 3 == 0);
+  CT.resize(2*BE.rows(),T.cols());
   BET.resize(BE.rows(),2);
   for(int e = 0;e<BE.rows();e++)
   {
     BET(e,0) = 2*e;
     BET(e,1) = 2*e+1;
-    Matrix4d t;
-    t << T.block(e*4,0,4,3).transpose(), 0,0,0,0;
-    Affine3d a;
-    a.matrix() = t;
-    Vector3d c0 = C.row(BE(e,0));
-    Vector3d c1 = C.row(BE(e,1));
-    CT.row(2*e) =   a * c0;
-    CT.row(2*e+1) = a * c1;
+    // [c 1] times the stacked transposed transformation(s) of this bone
+    RowVector4d c0,c1;
+    c0 << C.row(BE(e,0)), 1;
+    c1 << C.row(BE(e,1)), 1;
+    CT.row(2*e) =   c0 * T.block(e*4,0,4,T.cols());
+    CT.row(2*e+1) = c1 * T.block(e*4,0,4,T.cols());
   }
 }
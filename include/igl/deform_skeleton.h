@@ -31,7 +31,11 @@ namespace igl
     Eigen::MatrixXd & CT,
     Eigen::MatrixXi & BET);
   // Inputs:
-  //   T  #BE*4 by 3 list of stacked transformation matrix
+  //   T  #BE*4 by 3*#poses list of stacked transformation matrices (e.g. as
+  //     output by the batched forward_kinematics)
+  // Outputs
+  //   CT  #BE*2 by 3*#poses list of deformed joint positions, columns
+  //     3*p+0..2 hold pose p
   IGL_INLINE void deform_skeleton(
     const Eigen::MatrixXd & C,
     const Eigen::MatrixXi & BE,
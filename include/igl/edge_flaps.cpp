@@ -6,7 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "edge_flaps.h"
-#include "unique_edge_map.h"
+#include "mesh_connectivity.h"
 #include <vector>
 #include <cassert>
 
@@ -49,11 +49,12 @@ IGL_INLINE void igl::edge_flaps(
   Eigen::MatrixXi & EF,
   Eigen::MatrixXi & EI)
 {
-  Eigen::MatrixXi allE;
-  std::vector<std::vector<int> > uE2E;
-  igl::unique_edge_map(F,allE,E,EMAP,uE2E);
-  // Const-ify to call overload
-  const auto & cE = E;
-  const auto & cEMAP = EMAP;
-  return edge_flaps(F,cE,cEMAP,EF,EI);
+  // Unique edges and flaps from a single pass over the directed edges
+  mesh_connectivity_data data;
+  mesh_connectivity(F,F.size() ? F.maxCoeff()+1 : 0,
+    MESH_CONNECTIVITY_E | MESH_CONNECTIVITY_EF,data);
+  E.swap(data.E);
+  EMAP.swap(data.EMAP);
+  EF.swap(data.EF);
+  EI.swap(data.EI);
 }
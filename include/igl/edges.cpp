@@ -7,31 +7,60 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "edges.h"
 
-#include "adjacency_matrix.h"
+#include "adjacency_list.h"
+#include <vector>
 
 IGL_INLINE void igl::edges( const Eigen::MatrixXi& F, Eigen::MatrixXi& E)
 {
-  // build adjacency matrix
-  Eigen::SparseMatrix<int> A;
-  igl::adjacency_matrix(F,A);
-  // Number of non zeros should be twice number of edges
-  assert(A.nonZeros()%2 == 0);
-  // Resize to fit edges
-  E.resize(A.nonZeros()/2,2);
-  int i = 0;
-  // Iterate over outside
-  for(int k=0; k<A.outerSize(); ++k)
+  return edges<Eigen::MatrixXi,Eigen::MatrixXi>(F,E);
+}
+
+template <typename DerivedF, typename DerivedE>
+IGL_INLINE void igl::edges(
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedE> & E)
+{
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  typedef typename DerivedE::Scalar Index;
+  typedef Eigen::Matrix<Index,Eigen::Dynamic,1> VectorI;
+  // Compressed adjacency: neighbors of each vertex in increasing order, so
+  // edges come out sorted by their larger then smaller vertex (the order of
+  // the column major adjacency matrix)
+  VectorI A,AI;
+  adjacency_list(F,A,AI);
+  const Index n = AI.size()-1;
+  // Number of smaller neighbors of each vertex
+  std::vector<Index> offset(n+1,0);
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(Index v = 0;v<n;v++)
+  {
+    Index k = AI(v);
+    while(k<AI(v+1) && A(k)<v)
+    {
+      k++;
+    }
+    offset[v+1] = k-AI(v);
+  }
+  for(Index v = 0;v<n;v++)
   {
-    // Iterate over inside
-    for(Eigen::SparseMatrix<int>::InnerIterator it (A,k); it; ++it)
+    offset[v+1] += offset[v];
+  }
+  E.resize(offset[n],2);
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(Index v = 0;v<n;v++)
+  {
+    for(Index i = offset[v];i<offset[v+1];i++)
     {
-      // only add edge in one direction
-      if(it.row()<it.col())
-      {
-        E(i,0) = it.row();
-        E(i,1) = it.col();
-        i++;
-      }
+      E(i,0) = A(AI(v)+i-offset[v]);
+      E(i,1) = v;
     }
   }
 }
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template void igl::edges<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template void igl::edges<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<long, -1, 2, 0, -1, 2> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 2, 0, -1, 2> >&);
+#endif
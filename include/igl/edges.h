@@ -25,6 +25,13 @@ namespace igl
   //
   // See also: adjacency_matrix
   IGL_INLINE void edges( const Eigen::MatrixXi& F, Eigen::MatrixXi& E);
+  // Templated variant, the scalar type of E sets the index width (e.g. long
+  // for meshes with more than 2^31 incidences). Built in parallel from the
+  // compressed adjacency_list.
+  template <typename DerivedF, typename DerivedE>
+  IGL_INLINE void edges(
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedE> & E);
 }
 
 #ifndef IGL_STATIC_LIBRARY
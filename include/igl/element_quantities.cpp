@@ -0,0 +1,300 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "element_quantities.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+
+// Number of elements per block, corner coordinates of a block are stored as
+// P[corner][coordinate][element]
+#define IGL_ELEMENT_QUANTITIES_BLOCK 64
+
+// Quantities of triangles f0 ... f0+nf-1 with corners in P
+static void element_quantities_triangles(
+  const double (&P)[4][3][IGL_ELEMENT_QUANTITIES_BLOCK],
+  const int dim,
+  const int f0,
+  const int nf,
+  const int type,
+  igl::element_quantities_data & data)
+{
+  using namespace std;
+  const int B = IGL_ELEMENT_QUANTITIES_BLOCK;
+  // Edge lengths, edge c is opposite corner c
+  double l[3][B];
+  if(type & (igl::ELEMENT_QUANTITIES_EDGE_LENGTHS |
+    igl::ELEMENT_QUANTITIES_INTERNAL_ANGLES |
+    igl::ELEMENT_QUANTITIES_COTMATRIX_ENTRIES))
+  {
+    for(int c = 0;c<3;c++)
+    {
+      const int i = (c+1)%3;
+      const int j = (c+2)%3;
+      for(int k = 0;k<nf;k++)
+      {
+        const double e = P[i][0][k]-P[j][0][k];
+        l[c][k] = e*e;
+      }
+      for(int d = 1;d<dim;d++)
+      {
+        for(int k = 0;k<nf;k++)
+        {
+          const double e = P[i][d][k]-P[j][d][k];
+          l[c][k] += e*e;
+        }
+      }
+      for(int k = 0;k<nf;k++)
+      {
+        l[c][k] = sqrt(l[c][k]);
+      }
+    }
+  }
+  if(type & igl::ELEMENT_QUANTITIES_EDGE_LENGTHS)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      double * L = &data.L(f0,c);
+      for(int k = 0;k<nf;k++)
+      {
+        L[k] = l[c][k];
+      }
+    }
+  }
+  if(type & igl::ELEMENT_QUANTITIES_DOUBLEAREA)
+  {
+    double * dblA = &data.dblA(f0);
+    if(dim == 2)
+    {
+      for(int k = 0;k<nf;k++)
+      {
+        const double rx = P[0][0][k]-P[2][0][k];
+        const double sx = P[1][0][k]-P[2][0][k];
+        const double ry = P[0][1][k]-P[2][1][k];
+        const double sy = P[1][1][k]-P[2][1][k];
+        dblA[k] = rx*sy - ry*sx;
+      }
+    }else
+    {
+      for(int k = 0;k<nf;k++)
+      {
+        double a2 = 0;
+        for(int x = 0;x<3;x++)
+        {
+          const int y = (x+1)%3;
+          const double rx = P[0][x][k]-P[2][x][k];
+          const double sx = P[1][x][k]-P[2][x][k];
+          const double ry = P[0][y][k]-P[2][y][k];
+          const double sy = P[1][y][k]-P[2][y][k];
+          const double a = rx*sy - ry*sx;
+          a2 += a*a;
+        }
+        dblA[k] = sqrt(a2);
+      }
+    }
+  }
+  if(type & igl::ELEMENT_QUANTITIES_INTERNAL_ANGLES)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      const double * s1 = l[c];
+      const double * s2 = l[(c+1)%3];
+      const double * s3 = l[(c+2)%3];
+      double * K = &data.K(f0,c);
+      for(int k = 0;k<nf;k++)
+      {
+        K[k] = acos((s3[k]*s3[k] + s2[k]*s2[k] - s1[k]*s1[k])/(2.*s3[k]*s2[k]));
+      }
+    }
+  }
+  if(type & igl::ELEMENT_QUANTITIES_NORMALS)
+  {
+    double * Nx = &data.N(f0,0);
+    double * Ny = &data.N(f0,1);
+    double * Nz = &data.N(f0,2);
+    for(int k = 0;k<nf;k++)
+    {
+      const double ux = P[1][0][k]-P[0][0][k];
+      const double uy = P[1][1][k]-P[0][1][k];
+      const double uz = P[1][2][k]-P[0][2][k];
+      const double vx = P[2][0][k]-P[0][0][k];
+      const double vy = P[2][1][k]-P[0][1][k];
+      const double vz = P[2][2][k]-P[0][2][k];
+      const double nx = uy*vz - uz*vy;
+      const double ny = uz*vx - ux*vz;
+      const double nz = ux*vy - uy*vx;
+      const double r = sqrt(nx*nx + ny*ny + nz*nz);
+      Nx[k] = r == 0 ? 0 : nx/r;
+      Ny[k] = r == 0 ? 0 : ny/r;
+      Nz[k] = r == 0 ? 0 : nz/r;
+    }
+  }
+  if(type & igl::ELEMENT_QUANTITIES_COTMATRIX_ENTRIES)
+  {
+    // Kahan's Heron's formula on sorted lengths (see doublearea(l,dblA))
+    double H[B];
+    for(int k = 0;k<nf;k++)
+    {
+      const double a = max(max(l[0][k],l[1][k]),l[2][k]);
+      const double b = max(min(l[0][k],l[1][k]),min(max(l[0][k],l[1][k]),l[2][k]));
+      const double c = min(min(l[0][k],l[1][k]),l[2][k]);
+      const double arg = (a+(b+c))*(c-(a-b))*(c+(a-b))*(a+(b-c));
+      H[k] = 2.0*0.25*sqrt(arg);
+    }
+    for(int c = 0;c<3;c++)
+    {
+      const double * l0 = l[c];
+      const double * l1 = l[(c+1)%3];
+      const double * l2 = l[(c+2)%3];
+      double * C = &data.C(f0,c);
+      for(int k = 0;k<nf;k++)
+      {
+        C[k] = (l1[k]*l1[k] + l2[k]*l2[k] - l0[k]*l0[k])/H[k]/4.0;
+      }
+    }
+  }
+}
+
+// Quantities of tets f0 ... f0+nf-1 with corners in P
+static void element_quantities_tets(
+  const double (&P)[4][3][IGL_ELEMENT_QUANTITIES_BLOCK],
+  const int dim,
+  const int f0,
+  const int nf,
+  const int type,
+  igl::element_quantities_data & data)
+{
+  using namespace std;
+  if(type & igl::ELEMENT_QUANTITIES_EDGE_LENGTHS)
+  {
+    // Same edge order as edge_lengths
+    const int edges[6][2] = {{3,0},{3,1},{3,2},{1,2},{2,0},{0,1}};
+    for(int e = 0;e<6;e++)
+    {
+      const int i = edges[e][0];
+      const int j = edges[e][1];
+      double * L = &data.L(f0,e);
+      for(int k = 0;k<nf;k++)
+      {
+        const double d0 = P[i][0][k]-P[j][0][k];
+        L[k] = d0*d0;
+      }
+      for(int d = 1;d<dim;d++)
+      {
+        for(int k = 0;k<nf;k++)
+        {
+          const double dd = P[i][d][k]-P[j][d][k];
+          L[k] += dd*dd;
+        }
+      }
+      for(int k = 0;k<nf;k++)
+      {
+        L[k] = sqrt(L[k]);
+      }
+    }
+  }
+  if((type & igl::ELEMENT_QUANTITIES_VOLUME) && dim == 3)
+  {
+    double * vol = &data.vol(f0);
+    for(int k = 0;k<nf;k++)
+    {
+      const double tx = P[0][0][k]-P[3][0][k];
+      const double ty = P[0][1][k]-P[3][1][k];
+      const double tz = P[0][2][k]-P[3][2][k];
+      const double ux = P[1][0][k]-P[3][0][k];
+      const double uy = P[1][1][k]-P[3][1][k];
+      const double uz = P[1][2][k]-P[3][2][k];
+      const double vx = P[2][0][k]-P[3][0][k];
+      const double vy = P[2][1][k]-P[3][1][k];
+      const double vz = P[2][2][k]-P[3][2][k];
+      vol[k] = -(tx*(uy*vz - uz*vy) + ty*(uz*vx - ux*vz) + tz*(ux*vy - uy*vx))/6.;
+    }
+  }
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE void igl::element_quantities(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const int type,
+  element_quantities_data & data)
+{
+  using namespace std;
+  const int m = F.rows();
+  const int ss = F.cols();
+  const int dim = V.cols();
+  assert((ss == 3 || ss == 4) && "F should contain triangles or tets");
+  assert((dim == 2 || dim == 3) && "V should be 2D or 3D");
+  data = element_quantities_data();
+  if(type & ELEMENT_QUANTITIES_EDGE_LENGTHS)
+  {
+    data.L.resize(m,ss == 3 ? 3 : 6);
+  }
+  if(ss == 3)
+  {
+    if(type & ELEMENT_QUANTITIES_DOUBLEAREA)
+    {
+      data.dblA.resize(m);
+    }
+    if(type & ELEMENT_QUANTITIES_INTERNAL_ANGLES)
+    {
+      data.K.resize(m,3);
+    }
+    if(type & ELEMENT_QUANTITIES_NORMALS)
+    {
+      assert(dim == 3 && "Normals need 3D positions");
+      data.N.resize(m,3);
+    }
+    if(type & ELEMENT_QUANTITIES_COTMATRIX_ENTRIES)
+    {
+      data.C.resize(m,3);
+    }
+  }else if((type & ELEMENT_QUANTITIES_VOLUME) && dim == 3)
+  {
+    data.vol.resize(m);
+  }
+  const int B = IGL_ELEMENT_QUANTITIES_BLOCK;
+  const int nb = (m+B-1)/B;
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int b = 0;b<nb;b++)
+  {
+    const int f0 = b*B;
+    const int nf = std::min(B,m-f0);
+    // Gather corners
+    double P[4][3][IGL_ELEMENT_QUANTITIES_BLOCK];
+    for(int c = 0;c<ss;c++)
+    {
+      for(int k = 0;k<nf;k++)
+      {
+        const int i = F(f0+k,c);
+        for(int d = 0;d<dim;d++)
+        {
+          P[c][d][k] = V(i,d);
+        }
+      }
+    }
+    if(ss == 3)
+    {
+      element_quantities_triangles(P,dim,f0,nf,type,data);
+    }else
+    {
+      element_quantities_tets(P,dim,f0,nf,type,data);
+    }
+  }
+}
+
+#undef IGL_ELEMENT_QUANTITIES_BLOCK
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template void igl::element_quantities<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, igl::element_quantities_data&);
+template void igl::element_quantities<Eigen::Matrix<double, -1, 3, 0, -1, 3>, Eigen::Matrix<int, -1, 3, 0, -1, 3> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 0, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, int, igl::element_quantities_data&);
+#endif
@@ -0,0 +1,83 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_ELEMENT_QUANTITIES_H
+#define IGL_ELEMENT_QUANTITIES_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+
+namespace igl
+{
+  // Outputs of element_quantities, "or" them together to request several
+  enum ElementQuantitiesType
+  {
+    // L (see edge_lengths), triangles or tets
+    ELEMENT_QUANTITIES_EDGE_LENGTHS = 1,
+    // dblA (see doublearea), triangles in 2D or 3D
+    ELEMENT_QUANTITIES_DOUBLEAREA = 2,
+    // K (see internal_angles), triangles
+    ELEMENT_QUANTITIES_INTERNAL_ANGLES = 4,
+    // N (see per_face_normals with Z = 0), triangles in 3D
+    ELEMENT_QUANTITIES_NORMALS = 8,
+    // C (see cotmatrix_entries), triangles
+    ELEMENT_QUANTITIES_COTMATRIX_ENTRIES = 16,
+    // vol (see volume), tets in 3D
+    ELEMENT_QUANTITIES_VOLUME = 32,
+    ELEMENT_QUANTITIES_ALL = 63
+  };
+  struct element_quantities_data;
+  // ELEMENT_QUANTITIES Compute several per-element quantities of a triangle or
+  // tet mesh in one pass. Elements are processed in blocks: the corners of a
+  // block are gathered once into per-coordinate arrays and each requested
+  // quantity is computed by a loop across the elements of the block (which the
+  // compiler vectorizes); blocks are distributed among threads. This replaces
+  // calling edge_lengths, doublearea, internal_angles, per_face_normals,
+  // cotmatrix_entries and volume one after another, each re-reading V.
+  //
+  // Each output performs the same floating point operations in the same order
+  // as the corresponding function, so for double precision V and outputs the
+  // results are bitwise identical (as long as the compiler does not contract
+  // them into fused multiply-adds and Eigen's approximate vectorized sqrt,
+  // EIGEN_FAST_MATH with AVX512, is not used).
+  //
+  // Inputs:
+  //   V  #V by dim list of vertex positions (dim is 2 or 3)
+  //   F  #F by 3 list of triangle indices or #F by 4 list of tet indices
+  //   type  "or" of ElementQuantitiesType values (values that do not apply to
+  //     F and dim are ignored)
+  // Outputs:
+  //   data  requested outputs (others are left empty)
+  //
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE void element_quantities(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const int type,
+    element_quantities_data & data);
+}
+
+struct igl::element_quantities_data
+{
+  // L  #F by 3 (triangles) or #F by 6 (tets) list of edge lengths
+  Eigen::MatrixXd L;
+  // dblA  #F list of double areas
+  Eigen::VectorXd dblA;
+  // K  #F by 3 list of internal angles
+  Eigen::MatrixXd K;
+  // N  #F by 3 list of unit normals, zero for degenerate triangles
+  Eigen::MatrixXd N;
+  // C  #F by 3 list of cotangent weights
+  Eigen::MatrixXd C;
+  // vol  #F list of signed tet volumes
+  Eigen::VectorXd vol;
+};
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "element_quantities.cpp"
+#endif
+
+#endif
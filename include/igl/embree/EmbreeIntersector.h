@@ -23,9 +23,29 @@
 
 #include <embree2/rtcore.h>
 #include <embree2/rtcore_ray.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <vector>
 
+// Number of rays traced together by the packet/stream queries, set by the
+// widest packet the instruction set this is compiled for supports
+#ifndef IGL_EMBREE_PACKET_SIZE
+#  if defined(__MIC__)
+#    define IGL_EMBREE_PACKET_SIZE 16
+#  elif defined(__AVX__)
+#    define IGL_EMBREE_PACKET_SIZE 8
+#  else
+#    define IGL_EMBREE_PACKET_SIZE 4
+#  endif
+#endif
+
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+
 namespace igl
 {
   class EmbreeIntersector
@@ -41,6 +61,18 @@ namespace igl
   public:
     typedef Eigen::Matrix<float,Eigen::Dynamic,3> PointMatrixType;
     typedef Eigen::Matrix<int,Eigen::Dynamic,3> FaceMatrixType;
+    // How the acceleration structure is built
+    enum BuildType
+    {
+      // Static scene with a high quality BVH: slowest to build, fastest to
+      // trace (default)
+      BUILD_HIGH_QUALITY = 0,
+      // Static scene with a quickly built BVH
+      BUILD_FAST = 1,
+      // Dynamic scene of deformable geometry: vertex positions may be changed
+      // with update, which refits the BVH instead of rebuilding it
+      BUILD_DEFORMABLE = 2
+    };
   public: 
     inline EmbreeIntersector();
   private:
@@ -55,11 +87,13 @@ namespace igl
     // Inputs:
     //   V  #V by 3 list of vertex positions
     //   F  #F by 3 list of Oriented triangles
+    //   build  how to build the acceleration structure
     // Side effects:
     //   The first time this is ever called the embree engine is initialized.
     inline void init(
       const PointMatrixType& V,
-      const FaceMatrixType& F);
+      const FaceMatrixType& F,
+      const BuildType build = BUILD_HIGH_QUALITY);
 
     // Initialize with a given mesh.
     //
@@ -67,12 +101,31 @@ namespace igl
     //   V  vector of #V by 3 list of vertex positions for each geometry
     //   F  vector of #F by 3 list of Oriented triangles for each geometry
     //   masks  a 32 bit mask to identify active geometries.
+    //   build  how to build the acceleration structure
     // Side effects:
     //   The first time this is ever called the embree engine is initialized.
     inline void init(
       const std::vector<const PointMatrixType*>& V,
       const std::vector<const FaceMatrixType*>& F,
-      const std::vector<int>& masks);
+      const std::vector<int>& masks,
+      const BuildType build = BUILD_HIGH_QUALITY);
+
+    // Move the vertices of a mesh initialized with BUILD_DEFORMABLE (e.g. the
+    // next frame of an animation). Only positions are uploaded (in parallel,
+    // directly from V) and the BVH is refit rather than rebuilt.
+    //
+    // Inputs:
+    //   V  #V by 3 list of new vertex positions of the (single) geometry
+    template <typename DerivedV>
+    inline void update(const Eigen::PlainObjectBase<DerivedV>& V);
+
+    // Move the vertices of several geometries initialized with
+    // BUILD_DEFORMABLE.
+    //
+    // Inputs:
+    //   V  vector of #V by 3 list of new vertex positions for each geometry
+    //     (same sizes as passed to init)
+    inline void update(const std::vector<const PointMatrixType*>& V);
 
     // Deinitialize embree datasctructures for current mesh.  Also called on
     // destruction: no need to call if you just want to init() once and
@@ -124,6 +177,14 @@ namespace igl
       bool closestHit = true) const;
 
     // Given a ray find all hits in order
+    //
+    // All hits are collected in a single traversal by an intersection filter
+    // that records and rejects every hit (so Embree must be built with
+    // intersection filter support, its default). Hits are sorted by t (ties
+    // by gid then id). A primitive is reported at most once and a crossing
+    // through a shared edge or vertex (hits of the same geometry at the same
+    // t up to a few ulps, each on the boundary of its triangle) is reported
+    // once, as the hit with the smallest id.
     // 
     // Inputs:
     //   origin     3d origin point of ray
@@ -133,7 +194,7 @@ namespace igl
     //   masks      a 32 bit mask to identify active geometries.
     // Output:
     //   hit        information about hit
-    //   num_rays   number of rays shot (at least one)
+    //   num_rays   number of rays shot (always one)
     // Returns true if and only if there was a hit
     inline bool intersectRay(
       const Eigen::RowVector3f& origin,
@@ -144,6 +205,27 @@ namespace igl
       float tfar = std::numeric_limits<float>::infinity(),
       int mask = 0xFFFFFFFF) const;
 
+    // Given many rays find all hits of each in order (see intersectRay
+    // above). Rays are traced in parallel.
+    //
+    // Inputs:
+    //   origins     #R by 3 list of ray origins, or 1 by 3 origin shared by
+    //     all rays
+    //   directions  #R by 3 list of (not necessarily normalized) directions
+    //   tnear      start of ray segments
+    //   tfar       end of ray segments
+    //   masks      a 32 bit mask to identify active geometries.
+    // Output:
+    //   hits  #R list of lists of hits
+    // Returns total number of hits
+    inline int intersectRays(
+      const PointMatrixType& origins,
+      const PointMatrixType& directions,
+      std::vector<std::vector<Hit> >& hits,
+      float tnear = 0,
+      float tfar = std::numeric_limits<float>::infinity(),
+      int mask = 0xFFFFFFFF) const;
+
     // Given a ray find the first hit
     // 
     // Inputs:
@@ -157,14 +239,80 @@ namespace igl
       const Eigen::RowVector3f& ab,
       Hit &hit,
       int mask = 0xFFFFFFFF) const;
+
+    // Given a ray determine whether it hits anything (without finding the
+    // first hit, which is cheaper)
+    //
+    // Inputs:
+    //   origin     3d origin point of ray
+    //   direction  3d (not necessarily normalized) direction vector of ray
+    //   tnear      start of ray segment
+    //   tfar       end of ray segment
+    //   masks      a 32 bit mask to identify active geometries.
+    // Returns true if and only if there was a hit
+    inline bool occludedRay(
+      const Eigen::RowVector3f& origin,
+      const Eigen::RowVector3f& direction,
+      float tnear = 0,
+      float tfar = std::numeric_limits<float>::infinity(),
+      int mask = 0xFFFFFFFF) const;
+
+    // Given many rays find the first hit of each. Rays are traced in packets
+    // of IGL_EMBREE_PACKET_SIZE rays.
+    //
+    // Inputs:
+    //   origins     #R by 3 list of ray origins, or 1 by 3 origin shared by
+    //     all rays
+    //   directions  #R by 3 list of (not necessarily normalized) directions
+    //   tnear      start of ray segments
+    //   tfar       end of ray segments
+    //   masks      a 32 bit mask to identify active geometries.
+    // Output:
+    //   hits  #R list of first hits, hits[r].id = hits[r].gid = -1 if ray r
+    //     did not hit anything
+    // Returns number of rays that hit
+    inline int intersectRays(
+      const PointMatrixType& origins,
+      const PointMatrixType& directions,
+      std::vector<Hit>& hits,
+      float tnear = 0,
+      float tfar = std::numeric_limits<float>::infinity(),
+      int mask = 0xFFFFFFFF) const;
+
+    // Given many rays determine whether each hits anything. Rays are traced
+    // in packets of IGL_EMBREE_PACKET_SIZE rays.
+    //
+    // Inputs:
+    //   origins, directions, tnear, tfar, mask  see intersectRays
+    // Output:
+    //   occluded  #R list of flags whether ray r hit anything
+    // Returns number of rays that hit
+    inline int occludedRays(
+      const PointMatrixType& origins,
+      const PointMatrixType& directions,
+      std::vector<bool>& occluded,
+      float tnear = 0,
+      float tfar = std::numeric_limits<float>::infinity(),
+      int mask = 0xFFFFFFFF) const;
     
   private:
+#if IGL_EMBREE_PACKET_SIZE == 16
+    typedef RTCRay16 RTCRayPacket;
+#elif IGL_EMBREE_PACKET_SIZE == 8
+    typedef RTCRay8 RTCRayPacket;
+#else
+    typedef RTCRay4 RTCRayPacket;
+#endif
 
     struct Vertex   {float x,y,z,a;};
     struct Triangle {int v0, v1, v2;};
 
     RTCScene scene;
     unsigned geomID;
+    // Build type and id and number of vertices of each geometry
+    BuildType build;
+    std::vector<unsigned> geomIDs;
+    std::vector<int> num_vertices;
     Vertex* vertices;
     Triangle* triangles;
     bool initialized;
@@ -176,6 +324,33 @@ namespace igl
       float tnear,
       float tfar,
       int mask) const;
+
+    // Copy positions V of geometry g into its (mapped) vertex buffer
+    template <typename DerivedV>
+    inline void setVertices(const int g, const DerivedV& V);
+
+    // Ray collecting all its hits: the intersection filter records each hit
+    // in hits and rejects it so that traversal continues. Other rays are
+    // told apart by align0 (createRay sets it to 0).
+    struct AllHitsRay
+    {
+      RTCRay ray;
+      std::vector<Hit> * hits;
+    };
+    enum { ALL_HITS_RAY = 0x414C4C };
+    static inline void allHitsFilter(void* ptr, RTCRay& ray);
+
+    // Trace rays in packets, calling visit(r,ray,k) for the result of each
+    // ray r in lane k of the packet
+    template <typename Visit>
+    inline void tracePackets(
+      const PointMatrixType& origins,
+      const PointMatrixType& directions,
+      float tnear,
+      float tfar,
+      int mask,
+      bool occlusion,
+      const Visit & visit) const;
   };
 }
 
@@ -217,6 +392,9 @@ inline igl::EmbreeIntersector::EmbreeIntersector()
   :
   //scene(NULL),
   geomID(0),
+  build(BUILD_HIGH_QUALITY),
+  geomIDs(),
+  num_vertices(),
   triangles(NULL),
   vertices(NULL),
   initialized(false)
@@ -228,6 +406,9 @@ inline igl::EmbreeIntersector::EmbreeIntersector(
   :// To make -Weffc++ happy
   //scene(NULL),
   geomID(0),
+  build(BUILD_HIGH_QUALITY),
+  geomIDs(),
+  num_vertices(),
   triangles(NULL),
   vertices(NULL),
   initialized(false)
@@ -245,7 +426,8 @@ inline igl::EmbreeIntersector & igl::EmbreeIntersector::operator=(
 
 inline void igl::EmbreeIntersector::init(
   const PointMatrixType& V,
-  const FaceMatrixType& F)
+  const FaceMatrixType& F,
+  const BuildType build)
 {
   std::vector<const PointMatrixType*> Vtemp;
   std::vector<const FaceMatrixType*> Ftemp;
@@ -253,17 +435,19 @@ inline void igl::EmbreeIntersector::init(
   Vtemp.push_back(&V);
   Ftemp.push_back(&F);
   masks.push_back(0xFFFFFFFF);
-  init(Vtemp,Ftemp,masks);
+  init(Vtemp,Ftemp,masks,build);
 }
 
 inline void igl::EmbreeIntersector::init(
   const std::vector<const PointMatrixType*>& V,
   const std::vector<const FaceMatrixType*>& F,
-  const std::vector<int>& masks)
+  const std::vector<int>& masks,
+  const BuildType build)
 {
   
   if(initialized)
     deinit();
+  initialized = false;
   
   using namespace std;
   global_init();
@@ -275,22 +459,45 @@ inline void igl::EmbreeIntersector::init(
   }
   
   // create a scene
-  scene = rtcNewScene(RTC_SCENE_ROBUST | RTC_SCENE_HIGH_QUALITY,RTC_INTERSECT1);
+  this->build = build;
+  geomIDs.clear();
+  num_vertices.clear();
+  RTCSceneFlags sflags = RTC_SCENE_ROBUST;
+  switch(build)
+  {
+    default:
+    case BUILD_HIGH_QUALITY:
+      sflags = RTCSceneFlags(sflags | RTC_SCENE_HIGH_QUALITY);
+      break;
+    case BUILD_FAST:
+      break;
+    case BUILD_DEFORMABLE:
+      sflags = RTCSceneFlags(sflags | RTC_SCENE_DYNAMIC);
+      break;
+  }
+  scene = rtcNewScene(
+    sflags,
+#if IGL_EMBREE_PACKET_SIZE == 16
+    RTC_INTERSECT1 | RTC_INTERSECT16
+#elif IGL_EMBREE_PACKET_SIZE == 8
+    RTC_INTERSECT1 | RTC_INTERSECT8
+#else
+    RTC_INTERSECT1 | RTC_INTERSECT4
+#endif
+    );
 
   for(int g=0;g<(int)V.size();g++)
   {
     // create triangle mesh geometry in that scene
-    geomID = rtcNewTriangleMesh(scene,RTC_GEOMETRY_STATIC,F[g]->rows(),V[g]->rows(),1);
+    geomID = rtcNewTriangleMesh(
+      scene,
+      build == BUILD_DEFORMABLE ? RTC_GEOMETRY_DEFORMABLE : RTC_GEOMETRY_STATIC,
+      F[g]->rows(),V[g]->rows(),1);
+    geomIDs.push_back(geomID);
+    num_vertices.push_back(V[g]->rows());
 
     // fill vertex buffer
-    vertices = (Vertex*)rtcMapBuffer(scene,geomID,RTC_VERTEX_BUFFER);
-    for(int i=0;i<(int)V[g]->rows();i++)
-    {
-      vertices[i].x = (float)V[g]->coeff(i,0);
-      vertices[i].y = (float)V[g]->coeff(i,1);
-      vertices[i].z = (float)V[g]->coeff(i,2);
-    }
-    rtcUnmapBuffer(scene,geomID,RTC_VERTEX_BUFFER);
+    setVertices(g,*V[g]);
 
     // fill triangle buffer
     triangles = (Triangle*) rtcMapBuffer(scene,geomID,RTC_INDEX_BUFFER);
@@ -303,6 +510,7 @@ inline void igl::EmbreeIntersector::init(
     rtcUnmapBuffer(scene,geomID,RTC_INDEX_BUFFER);
 
     rtcSetMask(scene,geomID,masks[g]);
+    rtcSetIntersectionFilterFunction(scene,geomID,&allHitsFilter);
   }
 
   rtcCommit(scene);
@@ -324,6 +532,75 @@ igl::EmbreeIntersector
     deinit();
 }
 
+template <typename DerivedV>
+inline void igl::EmbreeIntersector::update(
+  const Eigen::PlainObjectBase<DerivedV>& V)
+{
+  if(!initialized || build != BUILD_DEFORMABLE || geomIDs.size() != 1)
+  {
+    std::cerr << "Embree: Only deformable geometry can be updated!" << std::endl;
+    return;
+  }
+  if(V.rows() != num_vertices[0])
+  {
+    std::cerr << "Embree: Number of vertices cannot change!" << std::endl;
+    return;
+  }
+  setVertices(0,V);
+  rtcCommit(scene);
+  if(rtcGetError() != RTC_NO_ERROR)
+      std::cerr << "Embree: An error occured while updating the geometry!" << std::endl;
+}
+
+inline void igl::EmbreeIntersector::update(
+  const std::vector<const PointMatrixType*>& V)
+{
+  if(!initialized || build != BUILD_DEFORMABLE || 
+    V.size() != geomIDs.size())
+  {
+    std::cerr << "Embree: Only deformable geometry can be updated!" << std::endl;
+    return;
+  }
+  for(int g = 0;g<(int)V.size();g++)
+  {
+    if(V[g]->rows() != num_vertices[g])
+    {
+      std::cerr << "Embree: Number of vertices cannot change!" << std::endl;
+      return;
+    }
+  }
+  for(int g = 0;g<(int)V.size();g++)
+  {
+    setVertices(g,*V[g]);
+  }
+  rtcCommit(scene);
+  if(rtcGetError() != RTC_NO_ERROR)
+      std::cerr << "Embree: An error occured while updating the geometry!" << std::endl;
+}
+
+template <typename DerivedV>
+inline void igl::EmbreeIntersector::setVertices(
+  const int g,
+  const DerivedV& V)
+{
+  assert(V.cols() == 3 && "V should be 3D");
+  const int n = V.rows();
+  Vertex * buffer = (Vertex*)rtcMapBuffer(scene,geomIDs[g],RTC_VERTEX_BUFFER);
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(int i = 0;i<n;i++)
+  {
+    buffer[i].x = (float)V.coeff(i,0);
+    buffer[i].y = (float)V.coeff(i,1);
+    buffer[i].z = (float)V.coeff(i,2);
+  }
+  rtcUnmapBuffer(scene,geomIDs[g],RTC_VERTEX_BUFFER);
+  if(build == BUILD_DEFORMABLE && initialized)
+  {
+    // Tell a committed scene that positions changed, so it refits
+    rtcUpdateBuffer(scene,geomIDs[g],RTC_VERTEX_BUFFER);
+  }
+}
+
 void igl::EmbreeIntersector::deinit()
 {
   if(scene)
@@ -430,94 +707,112 @@ igl::EmbreeIntersector
   int mask) const
 {
   using namespace std;
-  num_rays = 0;
+  num_rays = 1;
   hits.clear();
-  int last_id0 = -1;
-  double self_hits = 0;
-  // This epsilon is directly correleated to the number of missed hits, smaller
-  // means more accurate and slower
-  //const double eps = DOUBLE_EPS;
-  const double eps = FLOAT_EPS;
-  double min_t = tnear;
-  bool large_hits_warned = false;
-  RTCRay ray;
-  createRay(ray,origin,direction,tnear,std::numeric_limits<float>::infinity(),mask);
-
-  while(true)
+  AllHitsRay ahr;
+  createRay(ahr.ray,origin,direction,tnear,tfar,mask);
+  ahr.ray.align0 = ALL_HITS_RAY;
+  ahr.hits = &hits;
+  // Every hit is rejected by the filter, so this traverses the whole ray once
+  rtcIntersect(scene,ahr.ray);
+  if(hits.empty())
   {
-    ray.tnear = min_t;
-    ray.tfar = tfar;
-    ray.geomID = RTC_INVALID_GEOMETRY_ID;
-    ray.primID = RTC_INVALID_GEOMETRY_ID;
-    ray.instID = RTC_INVALID_GEOMETRY_ID;
-    num_rays++;
-    rtcIntersect(scene,ray);
-    if((unsigned)ray.geomID != RTC_INVALID_GEOMETRY_ID)
+    return true;
+  }
+  sort(hits.begin(),hits.end(),[](const Hit & a, const Hit & b)
     {
-      // Hit self again, progressively advance
-      if(ray.primID == last_id0 || ray.tfar <= min_t)
-      {
-        // push min_t a bit more
-        //double t_push = pow(2.0,self_hits-4)*(hit.t<eps?eps:hit.t);
-        double t_push = pow(2.0,self_hits)*eps;
-        #ifdef IGL_VERBOSE
-        std::cerr<<"  t_push: "<<t_push<<endl;
-        #endif
-        //o = o+t_push*d;
-        min_t += t_push;
-        self_hits++;
-      }
-      else
-      {
-        Hit hit;
-        hit.id = ray.primID;
-        hit.gid = ray.geomID;
-        hit.u = ray.u;
-        hit.v = ray.v;
-        hit.t = ray.tfar;
-        hits.push_back(hit);
-#ifdef IGL_VERBOSE
-        std::cerr<<"  t: "<<hit.t<<endl;
-#endif
-        // Instead of moving origin, just change min_t. That way calculations
-        // all use exactly same origin values
-        min_t = ray.tfar;
-
-        // reset t_scale
-        self_hits = 0;
-      }
-      last_id0 = ray.primID;
-    }
-    else
-      break; // no more hits
-    
-    if(hits.size()>1000 && !large_hits_warned)
+      return a.t<b.t || (a.t==b.t && (a.gid<b.gid || (a.gid==b.gid && a.id<b.id)));
+    });
+  // A hit within eps of its triangle's boundary. Embree's float barycentrics
+  // and t are only accurate to a few ulps, so FLOAT_EPS would be too tight.
+  const float eps = 16.0f*std::numeric_limits<float>::epsilon();
+  const auto on_boundary = [eps](const Hit & h)->bool
+  {
+    return std::min(std::min(h.u,h.v),1.0f-h.u-h.v) <= eps;
+  };
+  // Keep one hit of each run of hits at the same crossing: the one with the
+  // smallest id, so the kept hit does not depend on traversal order.
+  size_t k = 0;
+  // t of the first hit of the current run
+  float run_t = 0;
+  for(size_t h = 0;h<hits.size();h++)
+  {
+    if(k > 0)
     {
-      std::cout<<"Warning: Large number of hits..."<<endl;
-      std::cout<<"[ ";
-      for(vector<Hit>::iterator hit = hits.begin(); hit != hits.end();hit++)
+      Hit & prev = hits[k-1];
+      const Hit & cur = hits[h];
+      if(prev.gid == cur.gid && prev.id == cur.id && prev.t == cur.t)
       {
-        std::cout<<(hit->id+1)<<" ";
+        // Same primitive referenced from several BVH leaves
+        continue;
       }
-      
-      std::cout.precision(std::numeric_limits< double >::digits10);
-      std::cout<<"[ ";
-      
-      for(vector<Hit>::iterator hit = hits.begin(); hit != hits.end(); hit++)
+      if(prev.gid == cur.gid && 
+        cur.t-run_t <= eps*std::max(1.0f,std::fabs(cur.t)) &&
+        on_boundary(prev) && on_boundary(cur))
       {
-        std::cout<<(hit->t)<<endl;;
+        // Same crossing through a shared edge or vertex
+        if(cur.id < prev.id)
+        {
+          prev = cur;
+        }
+        continue;
       }
-
-      std::cout<<"]"<<endl;
-      large_hits_warned = true;
-
-      return hits.empty();
     }
+    run_t = hits[h].t;
+    hits[k++] = hits[h];
   }
-
+  hits.resize(k);
   return hits.empty();
 }
 
+inline int
+igl::EmbreeIntersector
+::intersectRays(
+  const PointMatrixType& origins,
+  const PointMatrixType& directions,
+  std::vector<std::vector<Hit> >& hits,
+  float tnear,
+  float tfar,
+  int mask) const
+{
+  assert((origins.rows() == 1 || origins.rows() == directions.rows()) &&
+    "origins should be 1 or #directions rows");
+  const int R = directions.rows();
+  hits.resize(R);
+  int num_hits = 0;
+#pragma omp parallel for reduction(+:num_hits)
+  for(int r = 0;r<R;r++)
+  {
+    int num_rays;
+    intersectRay(
+      origins.row(origins.rows() == 1 ? 0 : r),
+      directions.row(r),
+      hits[r],num_rays,tnear,tfar,mask);
+    num_hits += hits[r].size();
+  }
+  return num_hits;
+}
+
+inline void
+igl::EmbreeIntersector
+::allHitsFilter(void* /*ptr*/, RTCRay& ray)
+{
+  if(ray.align0 != ALL_HITS_RAY)
+  {
+    return;
+  }
+  AllHitsRay & ahr = reinterpret_cast<AllHitsRay&>(ray);
+  Hit hit;
+  hit.id = ray.primID;
+  hit.gid = ray.geomID;
+  hit.u = ray.u;
+  hit.v = ray.v;
+  hit.t = ray.tfar;
+  ahr.hits->push_back(hit);
+  // Reject, so traversal continues with the original tfar
+  ray.geomID = RTC_INVALID_GEOMETRY_ID;
+}
+
 inline bool 
 igl::EmbreeIntersector
 ::intersectSegment(const Eigen::RowVector3f& a, const Eigen::RowVector3f& ab, Hit &hit, int mask) const
@@ -557,6 +852,134 @@ igl::EmbreeIntersector
   ray.instID = RTC_INVALID_GEOMETRY_ID;
   ray.mask = mask;
   ray.time = 0.0f;
+  ray.align0 = 0;
+}
+
+inline bool 
+igl::EmbreeIntersector
+::occludedRay(
+  const Eigen::RowVector3f& origin,
+  const Eigen::RowVector3f& direction,
+  float tnear,
+  float tfar,
+  int mask) const
+{
+  RTCRay ray;
+  createRay(ray,origin,direction,tnear,tfar,mask);
+  rtcOccluded(scene,ray);
+  // geomID is set to 0 if the ray is occluded
+  return (unsigned)ray.geomID != RTC_INVALID_GEOMETRY_ID;
+}
+
+template <typename Visit>
+inline void
+igl::EmbreeIntersector
+::tracePackets(
+  const PointMatrixType& origins,
+  const PointMatrixType& directions,
+  float tnear,
+  float tfar,
+  int mask,
+  bool occlusion,
+  const Visit & visit) const
+{
+  const int K = IGL_EMBREE_PACKET_SIZE;
+  const int R = directions.rows();
+  assert((origins.rows() == 1 || origins.rows() == R) &&
+    "origins should be 1 or #directions rows");
+  const bool shared = origins.rows() == 1;
+  RTCRayPacket ray;
+  RTCORE_ALIGN(64) int valid[K];
+  for(int r0 = 0;r0<R;r0+=K)
+  {
+    const int nk = std::min(K,R-r0);
+    for(int k = 0;k<K;k++)
+    {
+      // Inactive lanes repeat the last ray so that they hold valid data
+      const int r = std::min(r0+k,R-1);
+      const int o = shared ? 0 : r;
+      valid[k] = k<nk ? -1 : 0;
+      ray.orgx[k] = origins(o,0);
+      ray.orgy[k] = origins(o,1);
+      ray.orgz[k] = origins(o,2);
+      ray.dirx[k] = directions(r,0);
+      ray.diry[k] = directions(r,1);
+      ray.dirz[k] = directions(r,2);
+      ray.tnear[k] = tnear;
+      ray.tfar[k] = tfar;
+      ray.time[k] = 0.0f;
+      ray.mask[k] = mask;
+      ray.geomID[k] = RTC_INVALID_GEOMETRY_ID;
+      ray.primID[k] = RTC_INVALID_GEOMETRY_ID;
+      ray.instID[k] = RTC_INVALID_GEOMETRY_ID;
+    }
+#if IGL_EMBREE_PACKET_SIZE == 16
+    if(occlusion) rtcOccluded16(valid,scene,ray); else rtcIntersect16(valid,scene,ray);
+#elif IGL_EMBREE_PACKET_SIZE == 8
+    if(occlusion) rtcOccluded8(valid,scene,ray); else rtcIntersect8(valid,scene,ray);
+#else
+    if(occlusion) rtcOccluded4(valid,scene,ray); else rtcIntersect4(valid,scene,ray);
+#endif
+    for(int k = 0;k<nk;k++)
+    {
+      visit(r0+k,ray,k);
+    }
+  }
+}
+
+inline int
+igl::EmbreeIntersector
+::intersectRays(
+  const PointMatrixType& origins,
+  const PointMatrixType& directions,
+  std::vector<Hit>& hits,
+  float tnear,
+  float tfar,
+  int mask) const
+{
+  hits.resize(directions.rows());
+  int num_hits = 0;
+  tracePackets(origins,directions,tnear,tfar,mask,false,
+    [&hits,&num_hits](const int r, const RTCRayPacket& ray, const int k)
+    {
+      Hit & hit = hits[r];
+      if((unsigned)ray.geomID[k] != RTC_INVALID_GEOMETRY_ID)
+      {
+        hit.id = ray.primID[k];
+        hit.gid = ray.geomID[k];
+        hit.u = ray.u[k];
+        hit.v = ray.v[k];
+        hit.t = ray.tfar[k];
+        num_hits++;
+      }else
+      {
+        hit.id = -1;
+        hit.gid = -1;
+      }
+    });
+  return num_hits;
+}
+
+inline int
+igl::EmbreeIntersector
+::occludedRays(
+  const PointMatrixType& origins,
+  const PointMatrixType& directions,
+  std::vector<bool>& occluded,
+  float tnear,
+  float tfar,
+  int mask) const
+{
+  occluded.resize(directions.rows());
+  int num_hits = 0;
+  tracePackets(origins,directions,tnear,tfar,mask,true,
+    [&occluded,&num_hits](const int r, const RTCRayPacket& ray, const int k)
+    {
+      // geomID is set to 0 if the ray is occluded
+      occluded[r] = (unsigned)ray.geomID[k] != RTC_INVALID_GEOMETRY_ID;
+      num_hits += occluded[r];
+    });
+  return num_hits;
 }
 
 #endif //EMBREE_INTERSECTOR_H
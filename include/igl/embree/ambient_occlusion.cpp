@@ -9,6 +9,7 @@
 #include "EmbreeIntersector.h"
 #include <igl/random_dir.h>
 #include <igl/EPS.h>
+#include <vector>
 
 template <
   typename DerivedP,
@@ -27,31 +28,34 @@ IGL_INLINE void igl::ambient_occlusion(
   // Resize output
   S.resize(n,1);
   // Embree seems to be parallel when constructing but not when tracing rays
-#pragma omp parallel for
-  // loop over mesh vertices
-  for(int p = 0;p<n;p++)
+#pragma omp parallel
   {
-    const Vector3f origin = P.row(p).template cast<float>();
-    const Vector3f normal = N.row(p).template cast<float>();
-    int num_hits = 0;
-    MatrixXf D = random_dir_stratified(num_samples).cast<float>();
-    for(int s = 0;s<num_samples;s++)
+    // Per thread buffers, reused for every vertex
+    MatrixXd Dd;
+    EmbreeIntersector::PointMatrixType origin(1,3),D(num_samples,3);
+    std::vector<bool> occluded;
+#pragma omp for
+    // loop over mesh vertices
+    for(int p = 0;p<n;p++)
     {
-      //Vector3d d = random_dir();
-      Vector3f d = D.row(s);
-      if(d.dot(normal) < 0)
+      origin.row(0) = P.row(p).template cast<float>();
+      const Vector3f normal = N.row(p).template cast<float>();
+      random_dir_stratified(num_samples,Dd);
+      for(int s = 0;s<num_samples;s++)
       {
-        // reverse ray
-        d *= -1;
+        Vector3f d = Dd.row(s).cast<float>();
+        if(d.dot(normal) < 0)
+        {
+          // reverse ray
+          d *= -1;
+        }
+        D.row(s) = d;
       }
-      igl::Hit hit;
+      // Only whether each ray is blocked matters, not the first hit
       const float tnear = 1e-4f;
-      if(ei.intersectRay(origin,d,hit,tnear))
-      {
-        num_hits++;
-      }
+      const int num_hits = ei.occludedRays(origin,D,occluded,tnear);
+      S(p) = (double)num_hits/(double)num_samples;
     }
-    S(p) = (double)num_hits/(double)num_samples;
   }
 }
 
@@ -13,8 +13,9 @@
 #include "../massmatrix.h"
 #include "../mat_min.h"
 #include <Eigen/Sparse>
+#include <iostream>
 
-bool igl::bone_heat(
+IGL_INLINE bool igl::bone_heat(
   const Eigen::MatrixXd & V,
   const Eigen::MatrixXi & F,
   const Eigen::MatrixXd & C,
@@ -22,6 +23,42 @@ bool igl::bone_heat(
   const Eigen::MatrixXi & BE,
   const Eigen::MatrixXi & CE,
   Eigen::MatrixXd & W)
+{
+  BoneHeatData data;
+  bone_heat_precompute(V,F,data);
+  return bone_heat(V,F,C,P,BE,CE,data,W);
+}
+
+IGL_INLINE void igl::bone_heat_precompute(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  BoneHeatData & data)
+{
+  using namespace Eigen;
+  assert(F.cols() == 3 && "F should contain triangles.");
+  assert(V.cols() == 3 && "V should contain 3D positions.");
+  // "double sided lighting"
+  MatrixXi FF;
+  FF.resize(F.rows()*2,F.cols());
+  FF << F, F.rowwise().reverse();
+  // Initialize intersector
+  data.ei.init(V.cast<float>(),FF);
+  cotmatrix(V,F,data.L);
+  massmatrix(V,F,MASSMATRIX_TYPE_DEFAULT,data.M);
+  // -L+M*H has the pattern of -L+M for any diagonal H
+  SparseMatrix<double> Q = -data.L+data.M;
+  data.llt.analyzePattern(Q);
+}
+
+IGL_INLINE bool igl::bone_heat(
+  const Eigen::MatrixXd & V,
+  const Eigen::MatrixXi & F,
+  const Eigen::MatrixXd & C,
+  const Eigen::VectorXi & P,
+  const Eigen::MatrixXi & BE,
+  const Eigen::MatrixXi & CE,
+  BoneHeatData & data,
+  Eigen::MatrixXd & W)
 {
   using namespace std;
   using namespace Eigen;
@@ -30,46 +67,31 @@ bool igl::bone_heat(
   assert(BE.cols() == 2 && "BE should have #cols=2");
   assert(F.cols() == 3 && "F should contain triangles.");
   assert(V.cols() == 3 && "V should contain 3D positions.");
+  assert(data.L.rows() == V.rows() && "data should be precomputed for V");
 
   const int n = V.rows();
   const int np = P.rows();
   const int nb = BE.rows();
   const int m = np + nb;
 
-  // "double sided lighting"
-  MatrixXi FF;
-  FF.resize(F.rows()*2,F.cols());
-  FF << F, F.rowwise().reverse();
-  // Initialize intersector
-  EmbreeIntersector ei;
-  ei.init(V.cast<float>(),F.cast<int>());
-
-  typedef Matrix<bool,Dynamic,1> VectorXb;
-  typedef Matrix<bool,Dynamic,Dynamic> MatrixXb;
-  MatrixXb vis_mask(n,m);
   // Distances
   MatrixXd D(n,m);
-  // loop over points
-  for(int j = 0;j<np;j++)
-  {
-    const Vector3d p = C.row(P(j));
-    D.col(j) = (V.rowwise()-p.transpose()).rowwise().norm();
-    VectorXb vj;
-    bone_visible(V,F,ei,p,p,vj);
-    vis_mask.col(j) = vj;
-  }
-
-  // loop over bones
-  for(int j = 0;j<nb;j++)
+  // loop over points and bones
+#pragma omp parallel for
+  for(int j = 0;j<m;j++)
   {
-    const Vector3d s = C.row(BE(j,0));
-    const Vector3d d = C.row(BE(j,1));
-    VectorXd t,sqrD;
-    project_to_line_segment(V,s,d,t,sqrD);
-    D.col(np+j) = sqrD.array().sqrt();
-    VectorXb vj;
-    bone_visible(V,F,ei,s,d,vj);
-    vis_mask.col(np+j) = vj;
+    if(j<np)
+    {
+      const Vector3d p = C.row(P(j));
+      D.col(j) = (V.rowwise()-p.transpose()).rowwise().norm();
+    }else
+    {
+      const Vector3d s = C.row(BE(j-np,0));
+      const Vector3d d = C.row(BE(j-np,1));
+      VectorXd t,sqrD;
+      project_to_line_segment(V,s,d,t,sqrD);
+      D.col(j) = sqrD.array().sqrt();
+    }
   }
 
   if(CE.rows() > 0)
@@ -77,28 +99,34 @@ bool igl::bone_heat(
     cerr<<"Error: Cage edges are not supported. Ignored."<<endl;
   }
 
-  MatrixXd PP = MatrixXd::Zero(n,m);
+  // Only the visibility of each vertex from its closest handle matters
   VectorXd min_D;
-  VectorXd Hdiag = VectorXd::Zero(n);
   VectorXi J;
   mat_min(D,2,min_D,J);
+  D.resize(0,0);
+  MatrixXd S(n,3),T(n,3);
   for(int i = 0;i<n;i++)
   {
-    PP(i,J(i)) = 1;
-    if(vis_mask(i,J(i)))
+    const int j = J(i);
+    S.row(i) = C.row(j<np ? P(j) : BE(j-np,0));
+    T.row(i) = C.row(j<np ? P(j) : BE(j-np,1));
+  }
+  Matrix<bool,Dynamic,1> vis;
+  bone_visible_per_vertex(V,F,data.ei,S,T,vis);
+  VectorXd Hdiag = VectorXd::Zero(n);
+  for(int i = 0;i<n;i++)
+  {
+    if(vis(i))
     {
-      double hii = pow(min_D(i),-2.); 
+      double hii = pow(min_D(i),-2.);
       Hdiag(i) = (hii>1e10?1e10:hii);
     }
   }
-  SparseMatrix<double> Q,L,M;
-  cotmatrix(V,F,L);
-  massmatrix(V,F,MASSMATRIX_TYPE_DEFAULT,M);
-  const auto & H = Hdiag.asDiagonal();
-  Q = (-L+M*H);
-  SimplicialLLT <SparseMatrix<double > > llt;
-  llt.compute(Q);
-  switch(llt.info())
+
+  // Only the diagonal H changed since bone_heat_precompute
+  SparseMatrix<double> Q = -data.L+data.M*Hdiag.asDiagonal();
+  data.llt.factorize(Q);
+  switch(data.llt.info())
   {
     case Eigen::Success:
       break;
@@ -110,7 +138,22 @@ bool igl::bone_heat(
       return false;
   }
 
-  const auto & rhs = M*H*PP;
-  W = llt.solve(rhs);
+  // rhs = M*H*PP, where PP(i,J(i)) = 1, assembled directly
+  W = MatrixXd::Zero(n,m);
+  for(int k = 0;k<data.M.outerSize();k++)
+  {
+    for(SparseMatrix<double>::InnerIterator it(data.M,k);it;++it)
+    {
+      W(it.row(),J(k)) += it.value()*Hdiag(k);
+    }
+  }
+  // Solve for all handles, one column per thread at a time
+  const SimplicialLLT<SparseMatrix<double> > & llt = data.llt;
+#pragma omp parallel for schedule(dynamic)
+  for(int j = 0;j<m;j++)
+  {
+    const VectorXd Wj = llt.solve(W.col(j));
+    W.col(j) = Wj;
+  }
   return true;
 }
@@ -8,7 +8,9 @@
 #ifndef IGL_BONE_HEAT_H
 #define IGL_BONE_HEAT_H
 #include "../igl_inline.h"
+#include "EmbreeIntersector.h"
 #include <Eigen/Core>
+#include <Eigen/Sparse>
 
 namespace igl
 {
@@ -35,6 +37,49 @@ namespace igl
     const Eigen::MatrixXi & BE,
     const Eigen::MatrixXi & CE,
     Eigen::MatrixXd & W);
+  // Quantities of bone_heat depending only on the mesh, so that rigging the
+  // same mesh again (e.g. after editing the skeleton) only refactors the
+  // heat-diffusion system numerically.
+  struct BoneHeatData
+  {
+    // ei  intersector over both sides of the faces of the mesh
+    // L  #V by #V cotangent Laplacian
+    // M  #V by #V mass matrix
+    // llt  Cholesky factorization of -L+M*H, with the sparsity pattern
+    //   (shared by all diagonal H) analyzed by bone_heat_precompute
+    EmbreeIntersector ei;
+    Eigen::SparseMatrix<double> L,M;
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double> > llt;
+  };
+  // Precompute bone_heat data for a mesh
+  //
+  // Inputs:
+  //   V  #V by 3 list of mesh vertex positions
+  //   F  #F by 3 list of mesh corner indices into V
+  // Outputs:
+  //   data  precomputed data
+  //
+  IGL_INLINE void bone_heat_precompute(
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    BoneHeatData & data);
+  // Inputs:
+  //   V,F,C,P,BE,CE  see above, where (V,F) is the mesh passed to
+  //     bone_heat_precompute
+  //   data  data from bone_heat_precompute
+  // Outputs:
+  //   W  #V by #P+#BE matrix of weights.
+  // Returns true only on success.
+  //
+  IGL_INLINE bool bone_heat(
+    const Eigen::MatrixXd & V,
+    const Eigen::MatrixXi & F,
+    const Eigen::MatrixXd & C,
+    const Eigen::VectorXi & P,
+    const Eigen::MatrixXi & BE,
+    const Eigen::MatrixXi & CE,
+    BoneHeatData & data,
+    Eigen::MatrixXd & W);
 };
 
 #ifndef IGL_STATIC_LIBRARY
@@ -9,7 +9,9 @@
 #include <igl/project_to_line.h>
 #include <igl/EPS.h>
 #include <igl/Timer.h>
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 template <
   typename DerivedV, 
@@ -33,113 +35,168 @@ IGL_INLINE void igl::bone_visible(
   return bone_visible(V,F,ei,s,d,flag);
 }
 
+// Test each vertex v against the bone segment(v,s,d) (see bone_visible)
 template <
   typename DerivedV, 
   typename DerivedF, 
-  typename DerivedSD,
-  typename Derivedflag>
-IGL_INLINE void igl::bone_visible(
+  typename Derivedflag,
+  typename Segment>
+static void bone_visible_segments(
   const Eigen::PlainObjectBase<DerivedV> & V,
   const Eigen::PlainObjectBase<DerivedF> & F,
   const igl::EmbreeIntersector & ei,
-  const Eigen::PlainObjectBase<DerivedSD> & s,
-  const Eigen::PlainObjectBase<DerivedSD> & d,
+  const Segment & segment,
   Eigen::PlainObjectBase<Derivedflag>  & flag)
 {
   using namespace igl;
   using namespace std;
   using namespace Eigen;
   flag.resize(V.rows());
-  const double sd_norm = (s-d).norm();
+  // Vertices are processed in blocks whose rays are traced together
+  const int block = 256;
+  const int num_blocks = (V.rows()+block-1)/block;
   // Embree seems to be parallel when constructing but not when tracing rays
-#pragma omp parallel for
-  // loop over mesh vertices
-  for(int v = 0;v<V.rows();v++)
+#pragma omp parallel
   {
-    const Vector3d Vv = V.row(v);
-    // Project vertex v onto line segment sd
-    //embree.intersectSegment
-    double t,sqrd;
-    Vector3d projv;
-    // degenerate bone, just snap to s
-    if(sd_norm < DOUBLE_EPS)
-    {
-      t = 0;
-      sqrd = (Vv-s).array().pow(2).sum();
-      projv = s;
-    }else
+    // Per thread buffers, reused for every block
+    EmbreeIntersector::PointMatrixType O(block,3),D(block,3);
+    VectorXd SQRD(block),DIR2(block);
+    vector<Hit> hits;
+#pragma omp for
+    for(int b = 0;b<num_blocks;b++)
     {
-      // project onto (infinite) line
-      project_to_line(
-        Vv(0),Vv(1),Vv(2),s(0),s(1),s(2),d(0),d(1),d(2),
-        projv(0),projv(1),projv(2),t,sqrd);
-      // handle projections past endpoints
-      if(t<0)
+      const int v0 = b*block;
+      const int nb = std::min(block,(int)V.rows()-v0);
+      O.conservativeResize(nb,3);
+      D.conservativeResize(nb,3);
+      // loop over mesh vertices
+      for(int i = 0;i<nb;i++)
       {
-        t = 0;
-        sqrd = (Vv-s).array().pow(2).sum();
-        projv = s;
-      } else if(t>1)
-      {
-        t = 1;
-        sqrd = (Vv-d).array().pow(2).sum();
-        projv = d;
+        const int v = v0+i;
+        const Vector3d Vv = V.row(v);
+        Vector3d s,d;
+        segment(v,s,d);
+        const double sd_norm = (s-d).norm();
+        // Project vertex v onto line segment sd
+        double t,sqrd;
+        Vector3d projv;
+        // degenerate bone, just snap to s
+        if(sd_norm < DOUBLE_EPS)
+        {
+          t = 0;
+          sqrd = (Vv-s).array().pow(2).sum();
+          projv = s;
+        }else
+        {
+          // project onto (infinite) line
+          project_to_line(
+            Vv(0),Vv(1),Vv(2),s(0),s(1),s(2),d(0),d(1),d(2),
+            projv(0),projv(1),projv(2),t,sqrd);
+          // handle projections past endpoints
+          if(t<0)
+          {
+            t = 0;
+            sqrd = (Vv-s).array().pow(2).sum();
+            projv = s;
+          } else if(t>1)
+          {
+            t = 1;
+            sqrd = (Vv-d).array().pow(2).sum();
+            projv = d;
+          }
+        }
+        // perhaps 1.0 should be 1.0-epsilon, or actually since we checking the
+        // incident face, perhaps 1.0 should be 1.0+eps
+        const Vector3d dir = (Vv-projv)*1.0;
+        O.row(i) = projv.cast<float>();
+        D.row(i) = dir.cast<float>();
+        SQRD(i) = sqrd;
+        DIR2(i) = dir.squaredNorm();
       }
-    }
-    igl::Hit hit;
-    // perhaps 1.0 should be 1.0-epsilon, or actually since we checking the
-    // incident face, perhaps 1.0 should be 1.0+eps
-    const Vector3d dir = (Vv-projv)*1.0;
-    if(ei.intersectSegment(
-       projv.template cast<float>(),
-       dir.template cast<float>(), 
-       hit))
-    {
-      // mod for double sided lighting
-      const int fi = hit.id % F.rows();
-
-      //if(v == 1228-1)
-      //{
-      //  Vector3d bc,P;
-      //  bc << 1 - hit.u - hit.v, hit.u, hit.v; // barycentric
-      //  P = V.row(F(fi,0))*bc(0) + 
-      //      V.row(F(fi,1))*bc(1) + 
-      //      V.row(F(fi,2))*bc(2);
-      //  cout<<(fi+1)<<endl;
-      //  cout<<bc.transpose()<<endl;
-      //  cout<<P.transpose()<<endl;
-      //  cout<<hit.t<<endl;
-      //  cout<<(projv + dir*hit.t).transpose()<<endl;
-      //  cout<<Vv.transpose()<<endl;
-      //}
-
-      // Assume hit is valid, so not visible
-      flag(v) = false;
-      // loop around corners of triangle
-      for(int c = 0;c<F.cols();c++)
+      // Segments from the projections to the vertices
+      ei.intersectRays(O,D,hits,0,1.0);
+      for(int i = 0;i<nb;i++)
       {
-        if(F(fi,c) == v)
+        const int v = v0+i;
+        const Hit & hit = hits[i];
+        if(hit.id >= 0)
+        {
+          // mod for double sided lighting
+          const int fi = hit.id % F.rows();
+          // Assume hit is valid, so not visible
+          flag(v) = false;
+          // loop around corners of triangle
+          for(int c = 0;c<F.cols();c++)
+          {
+            if(F(fi,c) == v)
+            {
+              // hit self, so no hits before, so vertex v is visible
+              flag(v) = true;
+              break;
+            }
+          }
+          // Hit is actually past v
+          if(!flag(v) && (hit.t*hit.t*DIR2(i))>SQRD(i))
+          {
+            flag(v) = true;
+          }
+        }else
         {
-          // hit self, so no hits before, so vertex v is visible
+          // no hit so vectex v is visible
           flag(v) = true;
-          break;
         }
       }
-      // Hit is actually past v
-      if(!flag(v) && (hit.t*hit.t*dir.squaredNorm())>sqrd)
-      {
-        flag(v) = true;
-      }
-    }else
-    {
-      // no hit so vectex v is visible
-      flag(v) = true;
     }
   }
 }
 
+template <
+  typename DerivedV, 
+  typename DerivedF, 
+  typename DerivedSD,
+  typename Derivedflag>
+IGL_INLINE void igl::bone_visible(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const igl::EmbreeIntersector & ei,
+  const Eigen::PlainObjectBase<DerivedSD> & s,
+  const Eigen::PlainObjectBase<DerivedSD> & d,
+  Eigen::PlainObjectBase<Derivedflag>  & flag)
+{
+  const Eigen::Vector3d s3(s(0),s(1),s(2)), d3(d(0),d(1),d(2));
+  return bone_visible_segments(V,F,ei,
+    [&](const int,Eigen::Vector3d & sv,Eigen::Vector3d & dv)
+    {
+      sv = s3;
+      dv = d3;
+    },flag);
+}
+
+template <
+  typename DerivedV, 
+  typename DerivedF, 
+  typename DerivedSD,
+  typename Derivedflag>
+IGL_INLINE void igl::bone_visible_per_vertex(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const igl::EmbreeIntersector & ei,
+  const Eigen::PlainObjectBase<DerivedSD> & S,
+  const Eigen::PlainObjectBase<DerivedSD> & D,
+  Eigen::PlainObjectBase<Derivedflag>  & flag)
+{
+  assert(S.rows() == V.rows() && D.rows() == V.rows());
+  return bone_visible_segments(V,F,ei,
+    [&](const int v,Eigen::Vector3d & sv,Eigen::Vector3d & dv)
+    {
+      sv = S.row(v).transpose();
+      dv = D.row(v).transpose();
+    },flag);
+}
+
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template instanciation
 template void igl::bone_visible<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, 3, 1, 0, 3, 1>, Eigen::Matrix<bool, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, 3, 1, 0, 3, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, 3, 1, 0, 3, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<bool, -1, 1, 0, -1, 1> >&);
 template void igl::bone_visible<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, 1, 0, -1, 1>, Eigen::Matrix<bool, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 1, 0, -1, 1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<bool, -1, 1, 0, -1, 1> >&);
+template void igl::bone_visible_per_vertex<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<bool, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::EmbreeIntersector const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<bool, -1, 1, 0, -1, 1> >&);
 #endif
@@ -58,6 +58,26 @@ namespace igl
     const Eigen::PlainObjectBase<DerivedSD> & s,
     const Eigen::PlainObjectBase<DerivedSD> & d,
     Eigen::PlainObjectBase<Derivedflag>  & flag);
+  // Test each vertex against its own bone
+  //
+  // Inputs:
+  //  V,F,ei  see above
+  //  S  #V by 3 list of start end points of each vertex's bone
+  //  D  #V by 3 list of dest end points of each vertex's bone
+  // Output:
+  //  flag  #V by 1 list of bools (true) visible, (false) obstructed
+  template <
+    typename DerivedV, 
+    typename DerivedF, 
+    typename DerivedSD,
+    typename Derivedflag>
+  IGL_INLINE void bone_visible_per_vertex(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const igl::EmbreeIntersector & ei,
+    const Eigen::PlainObjectBase<DerivedSD> & S,
+    const Eigen::PlainObjectBase<DerivedSD> & D,
+    Eigen::PlainObjectBase<Derivedflag>  & flag);
 }
 #ifndef IGL_STATIC_LIBRARY
 #  include "bone_visible.cpp"
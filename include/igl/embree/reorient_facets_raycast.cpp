@@ -154,47 +154,89 @@ IGL_INLINE void igl::reorient_facets_raycast(
   vector<pair<int  , int  >> C_vote_parity(num_cc, make_pair(0, 0));        // sum of parity count for each ray
   
   if (is_verbose) cout << "shooting rays... ";
-#pragma omp parallel for
-  for (int i = 0; i < (int)ray_face.size(); ++i)
+  const int num_rays = ray_face.size();
+  // Without parity only the first hit (other than the ray's own face) matters:
+  // trace blocks of rays in packets and fall back to the all-hits query only
+  // for rays whose first hit is their own face
+  const int block = 256;
+  const int num_blocks = (num_rays+block-1)/block;
+#pragma omp parallel
   {
-    int      f = ray_face[i];
-    Vector3f o = ray_ori [i];
-    Vector3f d = ray_dir [i];
-    int c = C(f);
+    // Per thread buffers, reused for every block
+    EmbreeIntersector::PointMatrixType O(block,3), D(block,3);
+    vector<Hit> first_front, first_back;
+#pragma omp for
+    for (int r = 0; r < num_blocks; ++r)
+    {
+      const int r0 = r*block;
+      const int r1 = min(num_rays,r0+block);
+      if (!use_parity)
+      {
+        O.conservativeResize(r1-r0,3);
+        D.conservativeResize(r1-r0,3);
+        for (int i = r0; i < r1; ++i)
+        {
+          O.row(i-r0) = ray_ori[i];
+          D.row(i-r0) = ray_dir[i];
+        }
+        ei.intersectRays(O,  D, first_front);
+        D *= -1.0f;
+        ei.intersectRays(O,  D, first_back );
+      }
+      for (int i = r0; i < r1; ++i)
+      {
+        int      f = ray_face[i];
+        Vector3f o = ray_ori [i];
+        Vector3f d = ray_dir [i];
+        int c = C(f);
     
-    // shoot ray toward front & back
-    vector<Hit> hits_front;
-    vector<Hit> hits_back;
-    int num_rays_front;
-    int num_rays_back;
-    ei.intersectRay(o,  d, hits_front, num_rays_front);
-    ei.intersectRay(o, -d, hits_back , num_rays_back );
-    if (!hits_front.empty() && hits_front[0].id == f) hits_front.erase(hits_front.begin());
-    if (!hits_back .empty() && hits_back [0].id == f) hits_back .erase(hits_back .begin());
+        // shoot ray toward front & back
+        vector<Hit> hits_front;
+        vector<Hit> hits_back;
+        int num_rays_front;
+        int num_rays_back;
+        if (use_parity || first_front[i-r0].id == f)
+        {
+          ei.intersectRay(o,  d, hits_front, num_rays_front);
+        } else if (first_front[i-r0].id >= 0)
+        {
+          hits_front.push_back(first_front[i-r0]);
+        }
+        if (use_parity || first_back[i-r0].id == f)
+        {
+          ei.intersectRay(o, -d, hits_back , num_rays_back );
+        } else if (first_back[i-r0].id >= 0)
+        {
+          hits_back.push_back(first_back[i-r0]);
+        }
+        if (!hits_front.empty() && hits_front[0].id == f) hits_front.erase(hits_front.begin());
+        if (!hits_back .empty() && hits_back [0].id == f) hits_back .erase(hits_back .begin());
     
-    if (use_parity) {
+        if (use_parity) {
 #pragma omp atomic
-      C_vote_parity[c].first  += hits_front.size() % 2;
+          C_vote_parity[c].first  += hits_front.size() % 2;
 #pragma omp atomic
-      C_vote_parity[c].second += hits_back .size() % 2;
+          C_vote_parity[c].second += hits_back .size() % 2;
     
-    } else {
-      if (hits_front.empty())
-      {
+        } else {
+          if (hits_front.empty())
+          {
 #pragma omp atomic
-        C_vote_infinity[c].first++;
-      } else {
+            C_vote_infinity[c].first++;
+          } else {
 #pragma omp atomic
-        C_vote_distance[c].first += hits_front[0].t;
-      }
+            C_vote_distance[c].first += hits_front[0].t;
+          }
     
-      if (hits_back.empty())
-      {
+          if (hits_back.empty())
+          {
 #pragma omp atomic
-        C_vote_infinity[c].second++;
-      } else {
+            C_vote_infinity[c].second++;
+          } else {
 #pragma omp atomic
-        C_vote_distance[c].second += hits_back[0].t;
+            C_vote_distance[c].second += hits_back[0].t;
+          }
+        }
       }
     }
   }
@@ -9,6 +9,7 @@
 
 #include <map>
 #include "sort.h"
+#include <algorithm>
 #include <cassert>
 
 template <typename IntegerF, typename IntegerC>
@@ -50,9 +51,110 @@ IGL_INLINE void igl::face_occurrences(
   }
 }
 
+template <typename DerivedF, typename DerivedC>
+IGL_INLINE void igl::face_occurrences(
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  Eigen::PlainObjectBase<DerivedC> & C)
+{
+  using namespace std;
+  typedef typename DerivedF::Scalar Index;
+  typedef unsigned long long Hash;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  const int m = F.rows();
+  const int s = F.cols();
+  assert(s <= 4 && "Simplices should have at most 4 vertices");
+  // Sorted copy of each row and its hash
+  Eigen::Matrix<Index,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> sF(m,s);
+  vector<Hash> H(m);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int i = 0;i<m;i++)
+  {
+    Index r[4];
+    for(int c = 0;c<s;c++)
+    {
+      r[c] = F(i,c);
+    }
+    std::sort(r,r+s);
+    Hash h = 1469598103934665603ULL;
+    for(int c = 0;c<s;c++)
+    {
+      sF(i,c) = r[c];
+      h = (h ^ (Hash)r[c]) * 1099511628211ULL;
+      h ^= h >> 29;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    H[i] = h;
+  }
+  // Counting sort rows by partition (keeps increasing row order)
+  const int num_parts = 64;
+  vector<int> offset(num_parts+1,0);
+  for(int i = 0;i<m;i++)
+  {
+    offset[(H[i]>>58)+1]++;
+  }
+  for(int p = 0;p<num_parts;p++)
+  {
+    offset[p+1] += offset[p];
+  }
+  vector<int> R(m);
+  {
+    vector<int> next(offset.begin(),offset.end()-1);
+    for(int i = 0;i<m;i++)
+    {
+      R[next[H[i]>>58]++] = i;
+    }
+  }
+  // Count each face at its first occurrence, one hash table per partition
+  vector<int> first(m),count(m,0);
+#pragma omp parallel for
+  for(int p = 0;p<num_parts;p++)
+  {
+    const int np = offset[p+1]-offset[p];
+    size_t cap = 16;
+    while(cap < 2*(size_t)np)
+    {
+      cap <<= 1;
+    }
+    vector<int> table(cap,-1);
+    for(int k = offset[p];k<offset[p+1];k++)
+    {
+      const int i = R[k];
+      size_t t = H[i] & (cap-1);
+      while(true)
+      {
+        const int j = table[t];
+        if(j < 0)
+        {
+          table[t] = i;
+          first[i] = i;
+          break;
+        }
+        if(H[j] == H[i] && sF.row(j) == sF.row(i))
+        {
+          first[i] = j;
+          break;
+        }
+        t = (t+1) & (cap-1);
+      }
+      count[first[i]]++;
+    }
+  }
+  C.resize(m,1);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int i = 0;i<m;i++)
+  {
+    C(i) = count[first[i]];
+  }
+}
+
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template specialization
 // generated by autoexplicit.sh
 template void igl::face_occurrences<unsigned int, int>(std::vector<std::vector<unsigned int, std::allocator<unsigned int> >, std::allocator<std::vector<unsigned int, std::allocator<unsigned int> > > > const&, std::vector<int, std::allocator<int> >&);
 template void igl::face_occurrences<int, int>(std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > > const&, std::vector<int, std::allocator<int> >&);
+template void igl::face_occurrences<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
 #endif
@@ -9,6 +9,7 @@
 #define IGL_FACE_OCCURRENCES
 #include "igl_inline.h"
 
+#include <Eigen/Core>
 #include <vector>
 namespace igl
 {
@@ -23,6 +24,16 @@ namespace igl
   IGL_INLINE void face_occurrences(
     const std::vector<std::vector<IntegerF> > & F,
     std::vector<IntegerC> & C);
+  // Parallel version counting occurrences with a hash table of sorted rows
+  //
+  // Inputs:
+  //   F  #F by simplex-size (at most 4) list of simplices
+  // Outputs
+  //   C  #F list of counts
+  template <typename DerivedF, typename DerivedC>
+  IGL_INLINE void face_occurrences(
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedC> & C);
 }
 
 #ifndef IGL_STATIC_LIBRARY
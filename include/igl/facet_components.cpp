@@ -6,21 +6,38 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "facet_components.h"
-#include <igl/triangle_triangle_adjacency.h>
+#include "unique_edge_map.h"
+#include "union_find_components.h"
 #include <vector>
-#include <queue>
+
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+
 template <typename DerivedF, typename DerivedC>
 IGL_INLINE void igl::facet_components(
   const Eigen::PlainObjectBase<DerivedF> & F,
   Eigen::PlainObjectBase<DerivedC> & C)
 {
-  using namespace std;
-  typedef typename DerivedF::Index Index;
-  vector<vector<vector<Index > > > TT;
-  vector<vector<vector<Index > > > TTi;
-  triangle_triangle_adjacency(F,TT,TTi);
-  Eigen::VectorXi counts;
-  return facet_components(TT,C,counts);
+  using namespace Eigen;
+  const int m = F.rows();
+  // Directed edge e = f+c*m belongs to face f
+  MatrixXi E,uE;
+  VectorXi EMAP,uEC,uEE;
+  unique_edge_map(F,E,uE,EMAP,uEC,uEE);
+  // Each face is connected to the first face on each of its (unique) edges
+  MatrixXi G(m,F.cols()+1);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int f = 0;f<m;f++)
+  {
+    G(f,0) = f;
+    for(int c = 0;c<F.cols();c++)
+    {
+      G(f,c+1) = uEE(uEC(EMAP(f+c*m)))%m;
+    }
+  }
+  VectorXi counts;
+  union_find_components(m,G,C,counts);
 }
 
 template <
@@ -34,57 +51,39 @@ IGL_INLINE void igl::facet_components(
 {
   using namespace std;
   typedef TTIndex Index;
-  const Index m = TT.size();
-  C.resize(m,1);
-  vector<bool> seen(m,false);
-  Index id = 0;
-  vector<Index> vcounts;
-  for(Index g = 0;g<m;g++)
+  const int m = TT.size();
+  // Flatten adjacency into a list of face pairs
+  vector<Index> offset(m+1,0);
+  for(int f = 0;f<m;f++)
   {
-    if(seen[g])
+    for(const auto & c : TT[f])
     {
-      continue;
+      offset[f+1] += c.size();
     }
-    vcounts.push_back(0);
-    queue<Index> Q;
-    Q.push(g);
-    while(!Q.empty())
+    offset[f+1] += offset[f];
+  }
+  Eigen::Matrix<Index,Eigen::Dynamic,2> G(offset[m],2);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int f = 0;f<m;f++)
+  {
+    Index k = offset[f];
+    // Face f's neighbor lists opposite opposite each corner
+    for(const auto & c : TT[f])
     {
-      const Index f = Q.front();
-      Q.pop();
-      if(seen[f])
+      // Each neighbor
+      for(const auto & n : c)
       {
-        continue;
-      }
-      seen[f] = true;
-      vcounts[id]++;
-      C(f,0) = id;
-      // Face f's neighbor lists opposite opposite each corner
-      for(const auto & c : TT[f])
-      {
-        // Each neighbor
-        for(const auto & n : c)
-        {
-          if(!seen[n])
-          {
-            Q.push(n);
-          }
-        }
+        G(k,0) = f;
+        G(k,1) = n;
+        k++;
       }
     }
-    id++;
-  }
-  assert((size_t) id == vcounts.size());
-  const size_t ncc = vcounts.size();
-  assert((size_t)C.maxCoeff()+1 == ncc);
-  counts.resize(ncc,1);
-  for(size_t i = 0;i<ncc;i++)
-  {
-    counts(i) = vcounts[i];
   }
+  union_find_components(m,G,C,counts);
 }
 
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template specialization
+template void igl::facet_components<int, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(std::vector<std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >, std::allocator<std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > > > > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
 template void igl::facet_components<long, Eigen::Matrix<long, -1, 1, 0, -1, 1>, Eigen::Matrix<long, -1, 1, 0, -1, 1> >(std::vector<std::vector<std::vector<long, std::allocator<long> >, std::allocator<std::vector<long, std::allocator<long> > > >, std::allocator<std::vector<std::vector<long, std::allocator<long> >, std::allocator<std::vector<long, std::allocator<long> > > > > > const&, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 1, 0, -1, 1> >&);
 #endif
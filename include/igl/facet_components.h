@@ -12,7 +12,8 @@
 #include <vector>
 namespace igl
 {
-  // Compute connected components of facets based on edge-edge adjacency.
+  // Compute connected components of facets based on edge-edge adjacency
+  // (including non-manifold edges), in parallel using union_find_components.
   //
   // Inputs:
   //   F  #F by 3 list of triangle indices
@@ -6,6 +6,7 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "forward_kinematics.h"
+#include <algorithm>
 #include <functional>
 
 IGL_INLINE void igl::forward_kinematics(
@@ -79,6 +80,131 @@ IGL_INLINE void igl::forward_kinematics(
   }
 }
 
+IGL_INLINE void igl::forward_kinematics(
+  const Eigen::MatrixXd & C,
+  const Eigen::MatrixXi & BE,
+  const Eigen::VectorXi & P,
+  const Eigen::MatrixXd & dQ,
+  Eigen::MatrixXd & T)
+{
+  using namespace Eigen;
+  using namespace std;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  const int m = BE.rows();
+  const int n = dQ.rows();
+  const int dim = C.cols();
+  assert(dim == 3 && "Rotations are 3D quaternions");
+  assert(m == P.rows());
+  assert(dQ.cols() == 4*m);
+  // Order bones by depth so that parents always precede children
+  vector<int> depth(m,-1);
+  function<int (int) > depth_helper = [&] (int b)->int
+  {
+    if(depth[b] < 0)
+    {
+      depth[b] = P(b) < 0 ? 0 : depth_helper(P(b))+1;
+    }
+    return depth[b];
+  };
+  vector<int> order(m);
+  for(int b = 0;b<m;b++)
+  {
+    depth_helper(b);
+    order[b] = b;
+  }
+  stable_sort(order.begin(),order.end(),
+    [&depth](int a,int b){ return depth[a] < depth[b]; });
+
+  T.resize(m*(dim+1),dim*n);
+  // Poses are processed in blocks small enough to stay in cache
+  const int block = 64;
+  const int num_blocks = (n+block-1)/block;
+#pragma omp parallel for if (n*m>IGL_OMP_MIN_VALUE)
+  for(int k = 0;k<num_blocks;k++)
+  {
+    const int p0 = k*block;
+    const int np = std::min(block,n-p0);
+    // Absolute rotations (x,y,z,w) and translations per bone, one column per
+    // component, one row per pose
+    ArrayXXd Q(np,4*m),Tr(np,3*m);
+    ArrayXd t0(np),t1(np),t2(np);
+    for(int b : order)
+    {
+      const Vector3d r = C.row(BE(b,0)).transpose();
+      const auto dx = dQ.col(4*b+0).segment(p0,np).array();
+      const auto dy = dQ.col(4*b+1).segment(p0,np).array();
+      const auto dz = dQ.col(4*b+2).segment(p0,np).array();
+      const auto dw = dQ.col(4*b+3).segment(p0,np).array();
+      if(P(b) < 0)
+      {
+        // base case for roots
+        Q.col(4*b+0) = dx;
+        Q.col(4*b+1) = dy;
+        Q.col(4*b+2) = dz;
+        Q.col(4*b+3) = dw;
+        Tr.col(3*b+0) = r(0);
+        Tr.col(3*b+1) = r(1);
+        Tr.col(3*b+2) = r(2);
+      }else
+      {
+        const int p = P(b);
+        const auto px = Q.col(4*p+0);
+        const auto py = Q.col(4*p+1);
+        const auto pz = Q.col(4*p+2);
+        const auto pw = Q.col(4*p+3);
+        Q.col(4*b+0) = pw*dx + px*dw + py*dz - pz*dy;
+        Q.col(4*b+1) = pw*dy - px*dz + py*dw + pz*dx;
+        Q.col(4*b+2) = pw*dz + px*dy - py*dx + pz*dw;
+        Q.col(4*b+3) = pw*dw - px*dx - py*dy - pz*dz;
+        // vT[b] = vT[p] + vQ[p]*r - vQ[b]*r, start with vT[p] + vQ[p]*r
+        t0 = 2.*(py*r(2) - pz*r(1));
+        t1 = 2.*(pz*r(0) - px*r(2));
+        t2 = 2.*(px*r(1) - py*r(0));
+        Tr.col(3*b+0) = Tr.col(3*p+0) + r(0) + pw*t0 + (py*t2 - pz*t1);
+        Tr.col(3*b+1) = Tr.col(3*p+1) + r(1) + pw*t1 + (pz*t0 - px*t2);
+        Tr.col(3*b+2) = Tr.col(3*p+2) + r(2) + pw*t2 + (px*t1 - py*t0);
+      }
+      // subtract vQ[b]*r (same formula as Quaterniond * Vector3d)
+      const auto qx = Q.col(4*b+0);
+      const auto qy = Q.col(4*b+1);
+      const auto qz = Q.col(4*b+2);
+      const auto qw = Q.col(4*b+3);
+      t0 = 2.*(qy*r(2) - qz*r(1));
+      t1 = 2.*(qz*r(0) - qx*r(2));
+      t2 = 2.*(qx*r(1) - qy*r(0));
+      Tr.col(3*b+0) -= r(0) + qw*t0 + (qy*t2 - qz*t1);
+      Tr.col(3*b+1) -= r(1) + qw*t1 + (qz*t0 - qx*t2);
+      Tr.col(3*b+2) -= r(2) + qw*t2 + (qx*t1 - qy*t0);
+    }
+    // Scatter transposed [R t] blocks into the stacked layout
+    for(int b = 0;b<m;b++)
+    {
+      for(int i = 0;i<np;i++)
+      {
+        const double x = Q(i,4*b+0);
+        const double y = Q(i,4*b+1);
+        const double z = Q(i,4*b+2);
+        const double w = Q(i,4*b+3);
+        Block<MatrixXd> Tb = T.block(b*(dim+1),(p0+i)*dim,dim+1,dim);
+        Tb(0,0) = 1.-2.*(y*y+z*z);
+        Tb(1,0) = 2.*(x*y-z*w);
+        Tb(2,0) = 2.*(x*z+y*w);
+        Tb(0,1) = 2.*(x*y+z*w);
+        Tb(1,1) = 1.-2.*(x*x+z*z);
+        Tb(2,1) = 2.*(y*z-x*w);
+        Tb(0,2) = 2.*(x*z-y*w);
+        Tb(1,2) = 2.*(y*z+x*w);
+        Tb(2,2) = 1.-2.*(x*x+y*y);
+        Tb(3,0) = Tr(i,3*b+0);
+        Tb(3,1) = Tr(i,3*b+1);
+        Tb(3,2) = Tr(i,3*b+2);
+      }
+    }
+  }
+}
+
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template instanciation
 #endif
@@ -44,6 +44,25 @@ namespace igl
     const std::vector<
       Eigen::Quaterniond,Eigen::aligned_allocator<Eigen::Quaterniond> > & dQ,
     Eigen::MatrixXd & T);
+  // Batched version evaluating many poses of the same skeleton at once. Bones
+  // are visited once in order of their depth in the hierarchy and each
+  // quaternion/translation component is stored contiguously across poses, so
+  // the per-bone arithmetic vectorizes over poses. Blocks of poses are
+  // evaluated in parallel.
+  //
+  // Inputs:
+  //   dQ  #poses by #BE*4 list of relative rotations, columns b*4+0..3 hold
+  //     the x,y,z,w coefficients of bone b's rotation across all poses
+  // Outputs:
+  //   T  #BE*(dim+1) by dim*#poses horizontal stack of the per-pose
+  //     transformations as output above, so that M*T (with M from
+  //     lbs_matrix) deforms the mesh for every pose in one product
+  IGL_INLINE void forward_kinematics(
+    const Eigen::MatrixXd & C,
+    const Eigen::MatrixXi & BE,
+    const Eigen::VectorXi & P,
+    const Eigen::MatrixXd & dQ,
+    Eigen::MatrixXd & T);
 };
 
 #ifndef IGL_STATIC_LIBRARY
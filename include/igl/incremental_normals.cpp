@@ -0,0 +1,184 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "incremental_normals.h"
+#include "element_quantities.h"
+#include "vertex_triangle_adjacency.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+
+// Face normals and corner weights of faces G (rows of data.F listed in J)
+template <typename DerivedV>
+static void incremental_normals_faces(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::MatrixXi & G,
+  const std::vector<int> & J,
+  igl::incremental_normals_data & data)
+{
+  using namespace igl;
+  int type = ELEMENT_QUANTITIES_NORMALS;
+  switch(data.weighting)
+  {
+    case PER_VERTEX_NORMALS_WEIGHTING_TYPE_UNIFORM:
+      break;
+    default:
+      assert(false && "Unknown weighting type");
+    case PER_VERTEX_NORMALS_WEIGHTING_TYPE_DEFAULT:
+    case PER_VERTEX_NORMALS_WEIGHTING_TYPE_AREA:
+      type |= ELEMENT_QUANTITIES_DOUBLEAREA;
+      break;
+    case PER_VERTEX_NORMALS_WEIGHTING_TYPE_ANGLE:
+      type |= ELEMENT_QUANTITIES_INTERNAL_ANGLES;
+      break;
+  }
+  element_quantities_data Q;
+  element_quantities(V,G,type,Q);
+  const int m = G.rows();
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int g = 0;g<m;g++)
+  {
+    const int f = J.empty() ? g : J[g];
+    data.FN.row(f) = Q.N.row(g);
+    for(int c = 0;c<3;c++)
+    {
+      data.W(f,c) =
+        type & ELEMENT_QUANTITIES_DOUBLEAREA ? Q.dblA(g) :
+        type & ELEMENT_QUANTITIES_INTERNAL_ANGLES ? Q.K(g,c) : 1.;
+    }
+  }
+}
+
+// Vertex normal of v summed over its incident faces in increasing order, as
+// per_vertex_normals scatters them (zero for isolated vertices)
+static void incremental_normals_gather(
+  const int v,
+  igl::incremental_normals_data & data)
+{
+  double n[3] = {0,0,0};
+  for(int k = data.NI(v);k<data.NI(v+1);k++)
+  {
+    const int f = data.VF(k);
+    const double w = data.W(f,data.VFi(k));
+    for(int d = 0;d<3;d++)
+    {
+      n[d] += w*data.FN(f,d);
+    }
+  }
+  const double r = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+  for(int d = 0;d<3;d++)
+  {
+    data.N(v,d) = r == 0 ? 0 : n[d]/r;
+  }
+}
+
+template <typename DerivedV, typename DerivedF>
+IGL_INLINE void igl::incremental_normals_precompute(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const PerVertexNormalsWeightingType weighting,
+  incremental_normals_data & data)
+{
+  assert(V.cols() == 3 && "V should be 3D");
+  assert((F.rows() == 0 || F.cols() == 3) && "F should contain triangles");
+  const int n = V.rows();
+  const int m = F.rows();
+  data.weighting = weighting;
+  data.F = F.template cast<int>();
+  vertex_triangle_adjacency(data.F,n,data.VF,data.VFi,data.NI);
+  data.FN.resize(m,3);
+  data.W.resize(m,3);
+  incremental_normals_faces(V,data.F,std::vector<int>(),data);
+  data.N.resize(n,3);
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(int v = 0;v<n;v++)
+  {
+    incremental_normals_gather(v,data);
+  }
+}
+
+template <typename DerivedV, typename DerivedI, typename DerivedR>
+IGL_INLINE void igl::incremental_normals_update(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedI> & I,
+  incremental_normals_data & data,
+  Eigen::PlainObjectBase<DerivedR> & R)
+{
+  using namespace std;
+  const int n = V.rows();
+  if(n != data.N.rows())
+  {
+    const Eigen::MatrixXi F = data.F;
+    incremental_normals_precompute(V,F,data.weighting,data);
+    R.resize(n,1);
+    for(int v = 0;v<n;v++)
+    {
+      R(v) = v;
+    }
+    return;
+  }
+  // Faces incident on moved vertices
+  vector<char> marked(data.F.rows(),0);
+  vector<int> J;
+  for(int i = 0;i<I.size();i++)
+  {
+    const int v = I(i);
+    assert(v >= 0 && v < n && "I should index V");
+    for(int k = data.NI(v);k<data.NI(v+1);k++)
+    {
+      const int f = data.VF(k);
+      if(!marked[f])
+      {
+        marked[f] = 1;
+        J.push_back(f);
+      }
+    }
+  }
+  Eigen::MatrixXi G(J.size(),3);
+  for(int g = 0;g<(int)J.size();g++)
+  {
+    G.row(g) = data.F.row(J[g]);
+  }
+  incremental_normals_faces(V,G,J,data);
+  // Vertices of those faces
+  vector<char> touched(n,0);
+  vector<int> U;
+  for(int g = 0;g<G.rows();g++)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      if(!touched[G(g,c)])
+      {
+        touched[G(g,c)] = 1;
+        U.push_back(G(g,c));
+      }
+    }
+  }
+  std::sort(U.begin(),U.end());
+  const int nu = U.size();
+#pragma omp parallel for if (nu>IGL_OMP_MIN_VALUE)
+  for(int u = 0;u<nu;u++)
+  {
+    incremental_normals_gather(U[u],data);
+  }
+  R.resize(nu,1);
+  for(int u = 0;u<nu;u++)
+  {
+    R(u) = U[u];
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template void igl::incremental_normals_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::PerVertexNormalsWeightingType, igl::incremental_normals_data&);
+template void igl::incremental_normals_update<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, igl::incremental_normals_data&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+#endif
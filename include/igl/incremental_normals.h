@@ -0,0 +1,88 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_INCREMENTAL_NORMALS_H
+#define IGL_INCREMENTAL_NORMALS_H
+#include "igl_inline.h"
+#include "per_vertex_normals.h"
+#include <Eigen/Core>
+
+namespace igl
+{
+  struct incremental_normals_data;
+  // INCREMENTAL_NORMALS_PRECOMPUTE Compute face and vertex normals of a
+  // triangle mesh and remember the vertex-face incidences and per-corner
+  // weights so that normals can later be refreshed for moved vertices only
+  // with incremental_normals_update.
+  //
+  // Face normals and weights are computed with element_quantities. Each vertex
+  // normal is gathered from its incident faces (in parallel over vertices, so
+  // there are no write conflicts) in the same order as per_vertex_normals
+  // scatters them, so the results match per_face_normals and
+  // per_vertex_normals bit for bit.
+  //
+  // Inputs:
+  //   V  #V by 3 list of mesh vertex positions
+  //   F  #F by 3 list of mesh faces (must be triangles)
+  //   weighting  weighting type (see per_vertex_normals)
+  // Outputs:
+  //   data  FN and N along with the cached incidences and weights
+  //
+  // See also: per_vertex_normals, per_face_normals
+  template <typename DerivedV, typename DerivedF>
+  IGL_INLINE void incremental_normals_precompute(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const PerVertexNormalsWeightingType weighting,
+    incremental_normals_data & data);
+  // INCREMENTAL_NORMALS_UPDATE Refresh data.FN and data.N after some vertices
+  // moved. Only faces incident on moved vertices are recomputed and only
+  // vertices of those faces are gathered again.
+  //
+  // Inputs:
+  //   V  #V by 3 list of (possibly moved) mesh vertex positions
+  //   I  #I list of indices of moved vertices (duplicates are ignored)
+  //   data  output of incremental_normals_precompute (or a previous update)
+  // Outputs:
+  //   data  updated normals
+  //   R  #R sorted list of unique vertex indices whose normals were updated
+  //
+  // Note: Connectivity is taken from data, if faces change call
+  // incremental_normals_precompute again. If #V differs from the previous
+  // call everything is recomputed and R lists all vertices.
+  template <typename DerivedV, typename DerivedI, typename DerivedR>
+  IGL_INLINE void incremental_normals_update(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedI> & I,
+    incremental_normals_data & data,
+    Eigen::PlainObjectBase<DerivedR> & R);
+}
+
+struct igl::incremental_normals_data
+{
+  // FN  #F by 3 list of face normals (see per_face_normals)
+  // N  #V by 3 list of vertex normals (see per_vertex_normals)
+  Eigen::MatrixXd FN,N;
+  // weighting  weighting type
+  PerVertexNormalsWeightingType weighting;
+  // F  #F by 3 faces
+  // W  #F by 3 weight of each corner's face normal in its vertex normal
+  Eigen::MatrixXi F;
+  Eigen::MatrixXd W;
+  // VF, VFi, NI  vertex-face incidences (see CSR vertex_triangle_adjacency)
+  Eigen::VectorXi VF,VFi,NI;
+  incremental_normals_data():
+    FN(),N(),weighting(PER_VERTEX_NORMALS_WEIGHTING_TYPE_DEFAULT),F(),W(),
+    VF(),VFi(),NI()
+  {}
+};
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "incremental_normals.cpp"
+#endif
+
+#endif
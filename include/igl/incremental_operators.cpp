@@ -0,0 +1,298 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "incremental_operators.h"
+#include "doublearea.h"
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+// Per-face element values of faces J: cotangent entries C (see
+// cotmatrix_entries), mass matrix corner contributions A (see massmatrix) and
+// the two rotated edge vectors E13, E21 defining the gradient (see grad).
+// Faces with repeated indices get zeros.
+template <typename DerivedV, typename DerivedF, typename Scalar>
+static void incremental_operators_elements(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const std::vector<int> & J,
+  const igl::MassMatrixType type,
+  Eigen::Matrix<Scalar,Eigen::Dynamic,3> & C,
+  Eigen::Matrix<Scalar,Eigen::Dynamic,3> & A,
+  Eigen::Matrix<Scalar,Eigen::Dynamic,3> & E13,
+  Eigen::Matrix<Scalar,Eigen::Dynamic,3> & E21)
+{
+  using namespace Eigen;
+  const int k = J.size();
+  // edge lengths numbered same as opposite vertices
+  Matrix<Scalar,Dynamic,3> l(k,3);
+  std::vector<bool> skip(k);
+  for(int j = 0;j<k;j++)
+  {
+    const int f = J[j];
+    skip[j] = F(f,0)==F(f,1) || F(f,1)==F(f,2) || F(f,2)==F(f,0);
+    if(skip[j])
+    {
+      l.row(j).setZero();
+      continue;
+    }
+    l(j,0) = (V.row(F(f,1))-V.row(F(f,2))).norm();
+    l(j,1) = (V.row(F(f,2))-V.row(F(f,0))).norm();
+    l(j,2) = (V.row(F(f,0))-V.row(F(f,1))).norm();
+  }
+  Matrix<Scalar,Dynamic,1> dblA;
+  igl::doublearea(l,dblA);
+  C.resize(k,3);
+  A.resize(k,3);
+  const bool with_grad = V.cols() == 3;
+  E13.resize(with_grad?k:0,3);
+  E21.resize(with_grad?k:0,3);
+  for(int j = 0;j<k;j++)
+  {
+    if(skip[j])
+    {
+      C.row(j).setZero();
+      A.row(j).setZero();
+      if(with_grad)
+      {
+        E13.row(j).setZero();
+        E21.row(j).setZero();
+      }
+      continue;
+    }
+    // cotangents correctly divided by 4 (see cotmatrix_entries)
+    C(j,0) = (l(j,1)*l(j,1) + l(j,2)*l(j,2) - l(j,0)*l(j,0))/dblA(j)/4.0;
+    C(j,1) = (l(j,2)*l(j,2) + l(j,0)*l(j,0) - l(j,1)*l(j,1))/dblA(j)/4.0;
+    C(j,2) = (l(j,0)*l(j,0) + l(j,1)*l(j,1) - l(j,2)*l(j,2))/dblA(j)/4.0;
+    switch(type)
+    {
+      case igl::MASSMATRIX_TYPE_BARYCENTRIC:
+        A.row(j).setConstant(dblA(j)/6.0);
+        break;
+      case igl::MASSMATRIX_TYPE_VORONOI:
+      {
+        // Voronoi-hybrid areas (see massmatrix)
+        Matrix<Scalar,1,3> cosines;
+        cosines(0) = (l(j,2)*l(j,2)+l(j,1)*l(j,1)-l(j,0)*l(j,0))/(l(j,1)*l(j,2)*2.0);
+        cosines(1) = (l(j,0)*l(j,0)+l(j,2)*l(j,2)-l(j,1)*l(j,1))/(l(j,2)*l(j,0)*2.0);
+        cosines(2) = (l(j,1)*l(j,1)+l(j,0)*l(j,0)-l(j,2)*l(j,2))/(l(j,0)*l(j,1)*2.0);
+        if(cosines(0) < 0)
+        {
+          A.row(j) << 0.25*dblA(j),0.125*dblA(j),0.125*dblA(j);
+        }else if(cosines(1) < 0)
+        {
+          A.row(j) << 0.125*dblA(j),0.25*dblA(j),0.125*dblA(j);
+        }else if(cosines(2) < 0)
+        {
+          A.row(j) << 0.125*dblA(j),0.125*dblA(j),0.25*dblA(j);
+        }else
+        {
+          Matrix<Scalar,1,3> partial = cosines.array() * l.row(j).array();
+          partial *= 0.5*dblA(j)/partial.sum();
+          A(j,0) = (partial(1)+partial(2))*0.5;
+          A(j,1) = (partial(2)+partial(0))*0.5;
+          A(j,2) = (partial(0)+partial(1))*0.5;
+        }
+        break;
+      }
+      default:
+        assert(false && "Unsupported mass matrix type");
+    }
+    if(with_grad)
+    {
+      // rotate edges 90 degrees around normal (see grad)
+      const int f = J[j];
+      const Matrix<Scalar,1,3> v32 = V.row(F(f,2)) - V.row(F(f,1));
+      const Matrix<Scalar,1,3> v13 = V.row(F(f,0)) - V.row(F(f,2));
+      const Matrix<Scalar,1,3> v21 = V.row(F(f,1)) - V.row(F(f,0));
+      const Matrix<Scalar,1,3> n = v32.cross(v13);
+      const Scalar dblAn = n.norm();
+      const Matrix<Scalar,1,3> u = n / dblAn;
+      E21.row(j) = u.cross(v21).normalized() * (v21.norm() / dblAn);
+      E13.row(j) = u.cross(v13).normalized() * (v13.norm() / dblAn);
+    }
+  }
+}
+
+template <typename DerivedV, typename DerivedF, typename Scalar>
+IGL_INLINE void igl::incremental_operators_precompute(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const MassMatrixType type,
+  incremental_operators_data<Scalar> & data)
+{
+  using namespace Eigen;
+  using namespace std;
+  assert(F.cols() == 3 && "F must contain triangles");
+  assert(type != MASSMATRIX_TYPE_FULL);
+  const int n = V.rows();
+  const int m = F.rows();
+  data.type = type==MASSMATRIX_TYPE_DEFAULT?MASSMATRIX_TYPE_VORONOI:type;
+  vector<int> J(m);
+  for(int f = 0;f<m;f++)
+  {
+    J[f] = f;
+  }
+  Matrix<Scalar,Dynamic,3> E13,E21;
+  incremental_operators_elements(V,F,J,data.type,data.C,data.A,E13,E21);
+  data.F = F.template cast<int>();
+
+  // Same assembly as cotmatrix, massmatrix and grad
+  vector<Triplet<Scalar> > LIJV,MIJV,GIJV;
+  LIJV.reserve(m*3*4);
+  MIJV.reserve(m*3);
+  GIJV.reserve(E13.rows()*3*4);
+  for(int f = 0;f<m;f++)
+  {
+    for(int e = 0;e<3;e++)
+    {
+      const int source = data.F(f,(e+1)%3);
+      const int dest = data.F(f,(e+2)%3);
+      LIJV.push_back(Triplet<Scalar>(source,dest,data.C(f,e)));
+      LIJV.push_back(Triplet<Scalar>(dest,source,data.C(f,e)));
+      LIJV.push_back(Triplet<Scalar>(source,source,-data.C(f,e)));
+      LIJV.push_back(Triplet<Scalar>(dest,dest,-data.C(f,e)));
+      MIJV.push_back(Triplet<Scalar>(data.F(f,e),data.F(f,e),data.A(f,e)));
+    }
+    if(E13.rows() == m)
+    {
+      for(int r = 0;r<3;r++)
+      {
+        GIJV.push_back(Triplet<Scalar>(r*m+f,data.F(f,1),E13(f,r)));
+        GIJV.push_back(Triplet<Scalar>(r*m+f,data.F(f,0),-E13(f,r)));
+        GIJV.push_back(Triplet<Scalar>(r*m+f,data.F(f,2),E21(f,r)));
+        GIJV.push_back(Triplet<Scalar>(r*m+f,data.F(f,0),-E21(f,r)));
+      }
+    }
+  }
+  data.L.resize(n,n);
+  data.L.setFromTriplets(LIJV.begin(),LIJV.end());
+  data.M.resize(n,n);
+  data.M.setFromTriplets(MIJV.begin(),MIJV.end());
+  if(E13.rows() == m)
+  {
+    data.G.resize(3*m,n);
+    data.G.setFromTriplets(GIJV.begin(),GIJV.end());
+  }else
+  {
+    data.G.resize(0,0);
+  }
+}
+
+template <
+  typename DerivedV,
+  typename DerivedF,
+  typename DerivedI,
+  typename Scalar,
+  typename DerivedR>
+IGL_INLINE void igl::incremental_operators_update(
+  const Eigen::PlainObjectBase<DerivedV> & V,
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const Eigen::PlainObjectBase<DerivedI> & I,
+  incremental_operators_data<Scalar> & data,
+  Eigen::PlainObjectBase<DerivedR> & R)
+{
+  using namespace Eigen;
+  using namespace std;
+  const int n = V.rows();
+  const int m = F.rows();
+  if(n != data.L.rows() || m != data.F.rows())
+  {
+    incremental_operators_precompute(V,F,data.type,data);
+    R.resize(n,1);
+    for(int i = 0;i<n;i++)
+    {
+      R(i) = i;
+    }
+    return;
+  }
+  vector<int> J(I.data(),I.data()+I.size());
+  sort(J.begin(),J.end());
+  J.erase(unique(J.begin(),J.end()),J.end());
+  Matrix<Scalar,Dynamic,3> C,A,E13,E21;
+  incremental_operators_elements(V,F,J,data.type,C,A,E13,E21);
+  const bool with_grad = data.G.rows() == 3*m;
+
+  const auto degenerate = [](const int a, const int b, const int c)->bool
+  {
+    return a==b || b==c || c==a;
+  };
+  vector<int> RV;
+  RV.reserve(J.size()*6);
+  for(int j = 0;j<(int)J.size();j++)
+  {
+    const int f = J[j];
+    // Remove old contribution
+    if(!degenerate(data.F(f,0),data.F(f,1),data.F(f,2)))
+    {
+      for(int e = 0;e<3;e++)
+      {
+        const int source = data.F(f,(e+1)%3);
+        const int dest = data.F(f,(e+2)%3);
+        const Scalar c = data.C(f,e);
+        data.L.coeffRef(source,dest) -= c;
+        data.L.coeffRef(dest,source) -= c;
+        data.L.coeffRef(source,source) += c;
+        data.L.coeffRef(dest,dest) += c;
+        data.M.coeffRef(data.F(f,e),data.F(f,e)) -= data.A(f,e);
+        RV.push_back(data.F(f,e));
+        if(with_grad)
+        {
+          for(int r = 0;r<3;r++)
+          {
+            data.G.coeffRef(r*m+f,data.F(f,e)) = 0;
+          }
+        }
+      }
+    }
+    for(int e = 0;e<3;e++)
+    {
+      data.F(f,e) = F(f,e);
+    }
+    data.C.row(f) = C.row(j);
+    data.A.row(f) = A.row(j);
+    // Add new contribution
+    if(!degenerate(data.F(f,0),data.F(f,1),data.F(f,2)))
+    {
+      for(int e = 0;e<3;e++)
+      {
+        const int source = data.F(f,(e+1)%3);
+        const int dest = data.F(f,(e+2)%3);
+        const Scalar c = data.C(f,e);
+        data.L.coeffRef(source,dest) += c;
+        data.L.coeffRef(dest,source) += c;
+        data.L.coeffRef(source,source) -= c;
+        data.L.coeffRef(dest,dest) -= c;
+        data.M.coeffRef(data.F(f,e),data.F(f,e)) += data.A(f,e);
+        RV.push_back(data.F(f,e));
+      }
+      if(with_grad)
+      {
+        for(int r = 0;r<3;r++)
+        {
+          data.G.coeffRef(r*m+f,data.F(f,1)) = E13(j,r);
+          data.G.coeffRef(r*m+f,data.F(f,0)) = -E13(j,r)-E21(j,r);
+          data.G.coeffRef(r*m+f,data.F(f,2)) = E21(j,r);
+        }
+      }
+    }
+  }
+  sort(RV.begin(),RV.end());
+  RV.erase(unique(RV.begin(),RV.end()),RV.end());
+  R.resize(RV.size(),1);
+  for(int i = 0;i<(int)RV.size();i++)
+  {
+    R(i) = RV[i];
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template void igl::incremental_operators_precompute<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, double>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, igl::MassMatrixType, igl::incremental_operators_data<double>&);
+template void igl::incremental_operators_update<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, double, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> > const&, igl::incremental_operators_data<double>&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+#endif
@@ -0,0 +1,105 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_INCREMENTAL_OPERATORS_H
+#define IGL_INCREMENTAL_OPERATORS_H
+#include "igl_inline.h"
+#include "massmatrix.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+namespace igl
+{
+  template <typename Scalar>
+  struct incremental_operators_data;
+  // INCREMENTAL_OPERATORS_PRECOMPUTE Build the cotangent Laplacian, mass
+  // matrix and gradient of a triangle mesh and remember the per-face element
+  // contributions so that local edits can later be applied in place with
+  // incremental_operators_update.
+  //
+  // Templates:
+  //   DerivedV  derived type of eigen matrix for V (e.g. derived from
+  //     MatrixXd)
+  //   DerivedF  derived type of eigen matrix for F (e.g. derived from
+  //     MatrixXi)
+  //   Scalar  scalar type for eigen sparse matrix (e.g. double)
+  // Inputs:
+  //   V  #V by dim list of mesh vertex positions
+  //   F  #F by 3 list of mesh faces (must be triangles). Faces with repeated
+  //     indices (e.g. IGL_COLLAPSE_EDGE_NULL faces) contribute nothing.
+  //   type  mass matrix type (see massmatrix, FULL is not supported)
+  // Outputs:
+  //   data  L, M (and G if dim == 3) as output by cotmatrix, massmatrix and
+  //     grad along with per-face element values
+  //
+  // See also: cotmatrix, massmatrix, grad
+  template <typename DerivedV, typename DerivedF, typename Scalar>
+  IGL_INLINE void incremental_operators_precompute(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const MassMatrixType type,
+    incremental_operators_data<Scalar> & data);
+  // INCREMENTAL_OPERATORS_UPDATE Update data.L, data.M and data.G in place
+  // after a local edit, touching only entries of the listed faces. The old
+  // contribution of each listed face is subtracted and its new contribution is
+  // added. Entries for new edges are inserted, which leaves the matrices
+  // uncompressed (call makeCompressed() if needed).
+  //
+  // Inputs:
+  //   V  #V by dim list of (possibly moved) mesh vertex positions
+  //   F  #F by 3 list of (possibly changed) mesh faces
+  //   I  #I list of indices into F of faces whose vertex indices changed or
+  //     any of whose vertices moved (duplicates are ignored)
+  //   data  output of incremental_operators_precompute (or a previous update)
+  // Outputs:
+  //   data  updated operators
+  //   R  #R sorted list of unique vertex indices whose rows (and columns) of L
+  //     and M changed. Face i changes rows i, i+#F, i+2*#F of G.
+  //
+  // Note: If #V or #F differ from the previous call (e.g. after upsample)
+  // everything is rebuilt and R lists all vertices.
+  //
+  // Note: Each update accumulates floating point round-off in touched
+  // entries; call incremental_operators_precompute occasionally to resync.
+  template <
+    typename DerivedV,
+    typename DerivedF,
+    typename DerivedI,
+    typename Scalar,
+    typename DerivedR>
+  IGL_INLINE void incremental_operators_update(
+    const Eigen::PlainObjectBase<DerivedV> & V,
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const Eigen::PlainObjectBase<DerivedI> & I,
+    incremental_operators_data<Scalar> & data,
+    Eigen::PlainObjectBase<DerivedR> & R);
+}
+
+template <typename Scalar>
+struct igl::incremental_operators_data
+{
+  // L  #V by #V cotangent matrix (see cotmatrix)
+  // M  #V by #V mass matrix (see massmatrix)
+  // G  #F*3 by #V gradient operator (see grad), empty unless dim == 3
+  Eigen::SparseMatrix<Scalar> L,M,G;
+  // type  mass matrix type
+  MassMatrixType type;
+  // F  #F by 3 faces as last assembled
+  // C  #F by 3 cotangent entries as last assembled (see cotmatrix_entries)
+  // A  #F by 3 mass matrix corner contributions as last assembled
+  Eigen::MatrixXi F;
+  Eigen::Matrix<Scalar,Eigen::Dynamic,3> C,A;
+  incremental_operators_data():
+    L(),M(),G(),type(MASSMATRIX_TYPE_DEFAULT),F(),C(),A()
+  {}
+};
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "incremental_operators.cpp"
+#endif
+
+#endif
@@ -0,0 +1,183 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "mesh_connectivity.h"
+#include "vertex_triangle_adjacency.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+
+template <typename DerivedF>
+IGL_INLINE void igl::mesh_connectivity(
+  const Eigen::PlainObjectBase<DerivedF> & F,
+  const int n,
+  const int type,
+  mesh_connectivity_data & data)
+{
+  using namespace Eigen;
+  using namespace std;
+  assert((F.rows() == 0 || F.cols() == 3) && "F should contain triangles");
+  const int m = F.rows();
+  const int ne = 3*m;
+  data = mesh_connectivity_data();
+  if(type & MESH_CONNECTIVITY_VF)
+  {
+    vertex_triangle_adjacency(F,n,data.VF,data.VFi,data.NI);
+  }
+  if(!(type & (MESH_CONNECTIVITY_E | MESH_CONNECTIVITY_UE2E |
+    MESH_CONNECTIVITY_EF | MESH_CONNECTIVITY_TT)))
+  {
+    return;
+  }
+  // The only sort: bucket directed edges by their smaller vertex with a
+  // counting sort, then sort each (small) bucket by (larger vertex, e). This
+  // gives the same order as sorting the rows of all_edges after sorting each
+  // row (ties by e).
+  const int nv = F.size() == 0 ? 0 : F.maxCoeff()+1;
+  vector<int> offset(nv+1,0);
+  for(int f = 0;f<m;f++)
+  {
+    for(int c = 0;c<3;c++)
+    {
+      offset[std::min(F(f,(c+1)%3),F(f,(c+2)%3))+1]++;
+    }
+  }
+  for(int v = 0;v<nv;v++)
+  {
+    offset[v+1] += offset[v];
+  }
+  // (larger vertex, directed edge e)
+  vector<pair<int,int> > S(ne);
+  {
+    vector<int> next(offset.begin(),offset.end()-1);
+    for(int c = 0;c<3;c++)
+    {
+      for(int f = 0;f<m;f++)
+      {
+        const int i = F(f,(c+1)%3);
+        const int j = F(f,(c+2)%3);
+        S[next[std::min(i,j)]++] = make_pair(std::max(i,j),f+c*m);
+      }
+    }
+  }
+  // Number of unique edges starting in each bucket
+  vector<int> ucount(nv+1,0);
+#pragma omp parallel for if (nv>IGL_OMP_MIN_VALUE)
+  for(int v = 0;v<nv;v++)
+  {
+    std::sort(S.begin()+offset[v],S.begin()+offset[v+1]);
+    for(int k = offset[v];k<offset[v+1];k++)
+    {
+      if(k == offset[v] || S[k].first != S[k-1].first)
+      {
+        ucount[v+1]++;
+      }
+    }
+  }
+  for(int v = 0;v<nv;v++)
+  {
+    ucount[v+1] += ucount[v];
+  }
+  const int nu = ucount[nv];
+  // First sorted position of each unique edge
+  vector<int> start(nu+1);
+  start[nu] = ne;
+  MatrixXi & E = data.E;
+  VectorXi & EMAP = data.EMAP;
+  E.resize(nu,2);
+  EMAP.resize(ne);
+#pragma omp parallel for if (nv>IGL_OMP_MIN_VALUE)
+  for(int v = 0;v<nv;v++)
+  {
+    int u = ucount[v]-1;
+    for(int k = offset[v];k<offset[v+1];k++)
+    {
+      if(k == offset[v] || S[k].first != S[k-1].first)
+      {
+        start[++u] = k;
+        // Oriented as its first directed edge
+        const int e = S[k].second;
+        E(u,0) = F(e%m,(e/m+1)%3);
+        E(u,1) = F(e%m,(e/m+2)%3);
+      }
+      EMAP(S[k].second) = u;
+    }
+  }
+  offset.clear();
+  ucount.clear();
+  // Directed edges of each unique edge in face-major order (f,c), which is
+  // the order in which edge_flaps and triangle_triangle_adjacency visit them
+  vector<int> H(ne);
+#pragma omp parallel for if (nu>IGL_OMP_MIN_VALUE)
+  for(int u = 0;u<nu;u++)
+  {
+    for(int k = start[u];k<start[u+1];k++)
+    {
+      H[k] = (S[k].second%m)*3 + S[k].second/m;
+    }
+    std::sort(H.begin()+start[u],H.begin()+start[u+1]);
+  }
+  if(type & MESH_CONNECTIVITY_UE2E)
+  {
+    data.uEC = Map<const VectorXi>(&start[0],nu+1);
+    data.uEE.resize(ne);
+#pragma omp parallel for if (ne>IGL_OMP_MIN_VALUE)
+    for(int k = 0;k<ne;k++)
+    {
+      data.uEE(k) = S[k].second;
+    }
+  }
+  if(type & MESH_CONNECTIVITY_EF)
+  {
+    data.EF.setConstant(nu,2,-1);
+    data.EI.setConstant(nu,2,-1);
+#pragma omp parallel for if (nu>IGL_OMP_MIN_VALUE)
+    for(int u = 0;u<nu;u++)
+    {
+      for(int k = start[u];k<start[u+1];k++)
+      {
+        const int f = H[k]/3;
+        const int v = H[k]%3;
+        // Left or right flap w.r.t. edge orientation
+        const int s = F(f,(v+1)%3) == E(u,0) && F(f,(v+2)%3) == E(u,1) ? 0 : 1;
+        data.EF(u,s) = f;
+        data.EI(u,s) = v;
+      }
+    }
+  }
+  if(type & MESH_CONNECTIVITY_TT)
+  {
+    // Edge j of face f (F(f,j) to F(f,j+1)) is opposite corner (j+2)%3.
+    // Consecutive faces on an edge are paired (so non-manifold edges are
+    // linked as in triangle_triangle_adjacency).
+    data.TT.setConstant(m,3,-1);
+    data.TTi.setConstant(m,3,-1);
+#pragma omp parallel for if (nu>IGL_OMP_MIN_VALUE)
+    for(int u = 0;u<nu;u++)
+    {
+      for(int k = start[u]+1;k<start[u+1];k++)
+      {
+        const int f1 = H[k-1]/3, i1 = (H[k-1]%3+1)%3;
+        const int f2 = H[k]/3, i2 = (H[k]%3+1)%3;
+        data.TT(f1,i1) = f2;
+        data.TT(f2,i2) = f1;
+        data.TTi(f1,i1) = i2;
+        data.TTi(f2,i2) = i1;
+      }
+    }
+  }
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template void igl::mesh_connectivity<Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, int, igl::mesh_connectivity_data&);
+template void igl::mesh_connectivity<Eigen::Matrix<int, -1, 3, 0, -1, 3> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 3, 0, -1, 3> > const&, int, int, igl::mesh_connectivity_data&);
+#endif
@@ -0,0 +1,87 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_MESH_CONNECTIVITY_H
+#define IGL_MESH_CONNECTIVITY_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+
+namespace igl
+{
+  // Outputs of mesh_connectivity, "or" them together to request several
+  enum MeshConnectivityType
+  {
+    // E, EMAP (see unique_edge_map), always computed if any of the edge
+    // based outputs is requested
+    MESH_CONNECTIVITY_E = 1,
+    // uEC, uEE (see CSR unique_edge_map)
+    MESH_CONNECTIVITY_UE2E = 2,
+    // EF, EI (see edge_flaps)
+    MESH_CONNECTIVITY_EF = 4,
+    // TT, TTi (see triangle_triangle_adjacency)
+    MESH_CONNECTIVITY_TT = 8,
+    // VF, VFi, NI (see CSR vertex_triangle_adjacency)
+    MESH_CONNECTIVITY_VF = 16,
+    MESH_CONNECTIVITY_ALL = 31
+  };
+  struct mesh_connectivity_data;
+  // MESH_CONNECTIVITY Build several connectivity relations of a triangle mesh
+  // at once. Directed edges are sorted (in parallel) a single time and each
+  // requested output is filled from the same sorted edges, rather than
+  // calling unique_edge_map, edge_flaps, triangle_triangle_adjacency, etc.
+  // one after another.
+  //
+  // Inputs:
+  //   F  #F by 3 list of triangle indices
+  //   n  number of vertices #V (e.g. `F.maxCoeff()+1` or `V.rows()`), only
+  //     used for MESH_CONNECTIVITY_VF
+  //   type  "or" of MeshConnectivityType values
+  // Outputs:
+  //   data  requested outputs (others are left empty), identical to the
+  //     outputs of the corresponding functions
+  //
+  template <typename DerivedF>
+  IGL_INLINE void mesh_connectivity(
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    const int n,
+    const int type,
+    mesh_connectivity_data & data);
+}
+
+struct igl::mesh_connectivity_data
+{
+  // Directed edge e = f+c*#F is the edge of face f opposite corner c
+  //
+  // E  #E by 2 list of unique undirected edges, ordered as by
+  //   unique_simplices and oriented as their first directed edge
+  // EMAP  #F*3 list of indices into E, mapping each directed edge to unique
+  //   edge
+  Eigen::MatrixXi E;
+  Eigen::VectorXi EMAP;
+  // uEC  #E+1 list of offsets into uEE
+  // uEE  #F*3 list of directed edges, so that uEE(uEC(u)) ... uEE(uEC(u+1)-1)
+  //   are the directed edges of unique edge u (in increasing order)
+  Eigen::VectorXi uEC,uEE;
+  // EF  #E by 2 list of edge flaps (see edge_flaps), -1 on boundary edges
+  // EI  #E by 2 list of edge flap corners, -1 on boundary edges
+  Eigen::MatrixXi EF,EI;
+  // TT  #F by 3 list of adjacent faces across edge F(f,j),F(f,(j+1)%3), -1 on
+  //   boundary edges
+  // TTi  #F by 3 list of index of the same edge in TT(f,j), -1 on boundary
+  Eigen::MatrixXi TT,TTi;
+  // VF  #F*3 list of incident faces, VF(NI(i)) ... VF(NI(i+1)-1) are the faces
+  //   incident on vertex i
+  // VFi  #F*3 list of index of incidence within incident faces in VF
+  // NI  #V+1 list of offsets into VF and VFi
+  Eigen::VectorXi VF,VFi,NI;
+};
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "mesh_connectivity.cpp"
+#endif
+
+#endif
@@ -205,19 +205,32 @@ IGL_INLINE bool igl::min_quad_with_fixed_precompute(
 #ifdef MIN_QUAD_WITH_FIXED_CPP_DEBUG
     cout<<"    llt"<<endl;
 #endif
-      data.llt.compute(Auu);
-      switch(data.llt.info())
+      if(data.use_multigrid)
       {
-        case Eigen::Success:
-          break;
-        case Eigen::NumericalIssue:
-          cerr<<"Error: Numerical issue."<<endl;
-          return false;
-        default:
-          cerr<<"Error: Other."<<endl;
+#ifdef MIN_QUAD_WITH_FIXED_CPP_DEBUG
+    cout<<"    multigrid"<<endl;
+#endif
+        if(!algebraic_multigrid_precompute(Auu,data.multigrid))
+        {
           return false;
+        }
+        data.solver_type = min_quad_with_fixed_data<T>::MULTIGRID_PCG;
+      }else
+      {
+        data.llt.compute(Auu);
+        switch(data.llt.info())
+        {
+          case Eigen::Success:
+            break;
+          case Eigen::NumericalIssue:
+            cerr<<"Error: Numerical issue."<<endl;
+            return false;
+          default:
+            cerr<<"Error: Other."<<endl;
+            return false;
+        }
+        data.solver_type = min_quad_with_fixed_data<T>::LLT;
       }
-      data.solver_type = min_quad_with_fixed_data<T>::LLT;
     }else
     {
 #ifdef MIN_QUAD_WITH_FIXED_CPP_DEBUG
@@ -446,6 +459,25 @@ IGL_INLINE bool igl::min_quad_with_fixed_solve(
         // Not a bottleneck
         sol = data.lu.solve(NB);
         break;
+      case igl::min_quad_with_fixed_data<T>::MULTIGRID_PCG:
+      {
+        sol.resize(NB.rows(),NB.cols());
+        VectorXT NBj,solj;
+        for(int j = 0;j<NB.cols();j++)
+        {
+          NBj = NB.col(j);
+          // Start every column from zero (a n by 1 solj would be used as the
+          // initial guess)
+          solj.resize(0);
+          if(!algebraic_multigrid_solve(data.multigrid,NBj,solj))
+          {
+            cerr<<"Error: multigrid did not converge"<<endl;
+            return false;
+          }
+          sol.col(j) = solj;
+        }
+        break;
+      }
       default:
         cerr<<"Error: invalid solver type"<<endl;
         return false;
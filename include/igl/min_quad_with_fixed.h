@@ -8,6 +8,7 @@
 #ifndef IGL_MIN_QUAD_WITH_FIXED_H
 #define IGL_MIN_QUAD_WITH_FIXED_H
 #include "igl_inline.h"
+#include "algebraic_multigrid.h"
 
 #define EIGEN_YES_I_KNOW_SPARSE_MODULE_IS_NOT_STABLE_YET
 #include <Eigen/Core>
@@ -46,6 +47,11 @@ namespace igl
   //     using min_quad_with_fixed_solve
   // Returns true on success, false on error
   //
+  // If data.use_multigrid is set before calling, positive definite systems
+  // without linear equality constraints are not factored but solved using
+  // multigrid preconditioned conjugate gradients (see algebraic_multigrid.h),
+  // avoiding the fill-in of a sparse Cholesky factorization on large meshes.
+  //
   // Benchmark: For a harmonic solve on a mesh with 325K facets, matlab 2.2
   // secs, igl/min_quad_with_fixed.h 7.1 secs
   //
@@ -143,8 +149,14 @@ struct igl::min_quad_with_fixed_data
     LDLT = 1,
     LU = 2,
     QR_LLT = 3,
-    NUM_SOLVER_TYPES = 4
+    MULTIGRID_PCG = 4,
+    NUM_SOLVER_TYPES = 5
   } solver_type;
+  // Whether to use MULTIGRID_PCG rather than LLT when possible (set before
+  // calling min_quad_with_fixed_precompute)
+  bool use_multigrid;
+  // Multigrid hierarchy of A(unknown,unknown) and its solver parameters
+  algebraic_multigrid_data<T> multigrid;
   // Solvers
   Eigen::SimplicialLLT <Eigen::SparseMatrix<T > > llt;
   Eigen::SimplicialLDLT<Eigen::SparseMatrix<T > > ldlt;
@@ -169,6 +181,7 @@ struct igl::min_quad_with_fixed_data
   // Debug
   Eigen::SparseMatrix<T> NA;
   Eigen::Matrix<T,Eigen::Dynamic,Eigen::Dynamic> NB;
+  min_quad_with_fixed_data():use_multigrid(false){}
 };
 
 #ifndef IGL_STATIC_LIBRARY
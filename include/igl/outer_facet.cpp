@@ -9,7 +9,7 @@
 #include "sort.h"
 #include "vertex_triangle_adjacency.h"
 #include <iostream>
-#define IGL_OUTER_FACET_DEBUG
+//#define IGL_OUTER_FACET_DEBUG
 
 template <
   typename DerivedV,
@@ -22,11 +22,21 @@ IGL_INLINE Eigen::Vector3d igl::random_dir()
 }
 
 IGL_INLINE Eigen::MatrixXd igl::random_dir_stratified(const int n)
+{
+  Eigen::MatrixXd N;
+  random_dir_stratified(n,N);
+  return N;
+}
+
+template <typename DerivedN>
+IGL_INLINE void igl::random_dir_stratified(
+  const int n,
+  Eigen::PlainObjectBase<DerivedN> & N)
 {
   using namespace Eigen;
   using namespace std;
   const double m = floor(sqrt(double(n)));
-  MatrixXd N(n,3);
+  N.resize(n,3);
   int row = 0;
   for(int i = 0;i<m;i++)
   {
@@ -46,7 +56,11 @@ IGL_INLINE Eigen::MatrixXd igl::random_dir_stratified(const int n)
   // Finish off with uniform random directions
   for(;row<n;row++)
   {
-    N.row(row) = random_dir();
+    N.row(row) = random_dir().cast<typename DerivedN::Scalar>();
   }
-  return N;
 }
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template void igl::random_dir_stratified<Eigen::Matrix<double, -1, -1, 0, -1, -1> >(int, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&);
+#endif
@@ -22,6 +22,13 @@ namespace igl
   //   n  number of directions
   // Return n by 3 matrix of random directions
   IGL_INLINE Eigen::MatrixXd random_dir_stratified(const int n);
+  // Outputs:
+  //   N  n by 3 matrix of random directions (reuses the memory of N if it is
+  //     already n by 3)
+  template <typename DerivedN>
+  IGL_INLINE void random_dir_stratified(
+    const int n,
+    Eigen::PlainObjectBase<DerivedN> & N);
 }
 
 #ifndef IGL_STATIC_LIBRARY
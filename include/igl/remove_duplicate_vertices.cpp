@@ -6,11 +6,332 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can 
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "remove_duplicate_vertices.h"
-#include "round.h"
 #include "unique.h"
-#include "colon.h"
-#include "slice.h"
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <utility>
+#include <vector>
+
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+
+// Weld vertices of V closer than epsilon by hashing them into a grid of cells
+// of width 2*epsilon and comparing each vertex against the vertices of its own
+// cell and of the neighboring cells across the faces it is near. Close pairs
+// are merged with a union-find so that clusters are the connected components
+// of the "within epsilon" relation.
+//
+// Outputs:
+//   root  #V list so that root[i] is the smallest index of the cluster of i
+template <typename DerivedV>
+static void remove_duplicate_vertices_weld(
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const double epsilon,
+  std::vector<int> & root)
+{
+  using namespace std;
+  typedef unsigned long long Hash;
+  typedef long long Cell;
+  const int m = V.rows();
+  const int dim = V.cols();
+  const double width = 2.0*epsilon;
+  // Offset of the grid (in cells) so that data quantized to multiples of
+  // epsilon does not sit on cell faces or midplanes
+  const double shift = 0.2360679775;
+  // Integer cell coordinates and their hashes
+  vector<Cell> K((size_t)m*dim);
+  vector<Hash> H(m);
+  const auto hash_cell = [dim](const Cell * k)->Hash
+  {
+    Hash h = 1469598103934665603ULL;
+    for(int d = 0;d<dim;d++)
+    {
+      h = (h ^ (Hash)k[d]) * 1099511628211ULL;
+      h ^= h >> 29;
+    }
+    // Finalize so that adjacent cells do not land in adjacent slots
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  };
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int i = 0;i<m;i++)
+  {
+    for(int d = 0;d<dim;d++)
+    {
+      K[(size_t)i*dim+d] = (Cell)std::floor(double(V(i,d))/width+shift);
+    }
+    H[i] = hash_cell(&K[(size_t)i*dim]);
+  }
+  // Counting sort vertices by partition (keeps increasing vertex order)
+  const int num_parts = 64;
+  vector<int> offset(num_parts+1,0);
+  for(int i = 0;i<m;i++)
+  {
+    offset[(H[i]>>58)+1]++;
+  }
+  for(int p = 0;p<num_parts;p++)
+  {
+    offset[p+1] += offset[p];
+  }
+  vector<int> R(m);
+  {
+    vector<int> next(offset.begin(),offset.end()-1);
+    for(int i = 0;i<m;i++)
+    {
+      R[next[H[i]>>58]++] = i;
+    }
+  }
+  // One open addressing table of cells per partition. Each slot holds the
+  // hash, the first vertex (whose cell coordinates serve as key) and the
+  // index of a cell so that misses are resolved without touching K.
+  struct Slot
+  {
+    Hash h;
+    int first;
+    int cell;
+  };
+  vector<vector<Slot> > table(num_parts);
+  // first[i]  smallest index of a vertex in the same cell as vertex i
+  vector<int> first(m);
+  const auto same_cell = [&K,dim](const int i, const int j)->bool
+  {
+    return std::equal(&K[(size_t)i*dim],&K[(size_t)i*dim]+dim,&K[(size_t)j*dim]);
+  };
+#pragma omp parallel for
+  for(int p = 0;p<num_parts;p++)
+  {
+    const int np = offset[p+1]-offset[p];
+    size_t cap = 16;
+    while(cap < 2*(size_t)np)
+    {
+      cap <<= 1;
+    }
+    vector<Slot> & T = table[p];
+    const Slot empty = {0,-1,-1};
+    T.assign(cap,empty);
+    for(int k = offset[p];k<offset[p+1];k++)
+    {
+      const int i = R[k];
+      size_t s = H[i] & (cap-1);
+      while(true)
+      {
+        Slot & t = T[s];
+        if(t.first < 0)
+        {
+          t.h = H[i];
+          t.first = i;
+          first[i] = i;
+          break;
+        }
+        if(t.h == H[i] && same_cell(t.first,i))
+        {
+          first[i] = t.first;
+          break;
+        }
+        s = (s+1) & (cap-1);
+      }
+    }
+  }
+  // Number cells in order of their first vertex so that cells are visited
+  // with the same locality as the input
+  vector<int> cell(m);
+  int nc = 0;
+  for(int i = 0;i<m;i++)
+  {
+    cell[i] = first[i] == i ? nc++ : cell[first[i]];
+  }
+#pragma omp parallel for
+  for(int p = 0;p<num_parts;p++)
+  {
+    for(auto & t : table[p])
+    {
+      if(t.first >= 0)
+      {
+        t.cell = cell[t.first];
+      }
+    }
+  }
+  // Vertices of each cell (CSR, increasing vertex order within a cell)
+  vector<int> CI(nc+1,0),CV(m);
+  for(int i = 0;i<m;i++)
+  {
+    CI[cell[i]+1]++;
+  }
+  for(int c = 0;c<nc;c++)
+  {
+    CI[c+1] += CI[c];
+  }
+  {
+    vector<int> next(CI.begin(),CI.end()-1);
+    for(int i = 0;i<m;i++)
+    {
+      CV[next[cell[i]]++] = i;
+    }
+  }
+  // Occupancy bitmap of cell hashes (~16 bits per cell) small enough to stay
+  // in cache, so that most empty neighboring cells are rejected without
+  // probing the tables
+  size_t num_bits = 64;
+  while(num_bits < 16*(size_t)nc)
+  {
+    num_bits <<= 1;
+  }
+  vector<unsigned long long> occupied(num_bits/64,0);
+  for(int i = 0;i<m;i++)
+  {
+    const size_t b = H[i] & (num_bits-1);
+    occupied[b>>6] |= 1ULL<<(b&63);
+  }
+  // Global cell index of the cell with coordinates k, or -1
+  const auto find_cell = [&](const Cell * k)->int
+  {
+    const Hash h = hash_cell(k);
+    const size_t b = h & (num_bits-1);
+    if(!(occupied[b>>6] & (1ULL<<(b&63))))
+    {
+      return -1;
+    }
+    const int p = h>>58;
+    const vector<Slot> & T = table[p];
+    const size_t cap = T.size();
+    size_t s = h & (cap-1);
+    while(T[s].first >= 0)
+    {
+      const Slot & t = T[s];
+      if(t.h == h && std::equal(k,k+dim,&K[(size_t)t.first*dim]))
+      {
+        return t.cell;
+      }
+      s = (s+1) & (cap-1);
+    }
+    return -1;
+  };
+  int num_nbrs = 1;
+  for(int d = 0;d<dim;d++)
+  {
+    num_nbrs *= 3;
+  }
+  const double eps2 = epsilon*epsilon;
+  const auto close = [&V,dim,eps2](const int i, const int j)->bool
+  {
+    double d2 = 0;
+    for(int d = 0;d<dim;d++)
+    {
+      const double x = double(V(i,d))-double(V(j,d));
+      d2 += x*x;
+    }
+    return d2 <= eps2;
+  };
+  // Collect close pairs in parallel over chunks of cells. A vertex can only
+  // be within epsilon of a neighboring cell across the faces of its own cell
+  // that it is (about) within epsilon of, i.e. one side per coordinate. This
+  // relation is symmetric so pairs of different cells are kept only from the
+  // cell with smaller index.
+  const int num_chunks = std::max(1,std::min(nc,1024));
+  vector<vector<pair<int,int> > > P(num_chunks);
+#pragma omp parallel for if (nc>IGL_OMP_MIN_VALUE)
+  for(int b = 0;b<num_chunks;b++)
+  {
+    vector<Cell> k(dim);
+    // side[d]  bit 0 (1) set if lower (upper) neighbor along d is needed
+    vector<int> side(dim);
+    const int c0 = (long long)nc*b/num_chunks;
+    const int c1 = (long long)nc*(b+1)/num_chunks;
+    for(int c = c0;c<c1;c++)
+    {
+      const Cell * kc = &K[(size_t)CV[CI[c]]*dim];
+      std::fill(side.begin(),side.end(),0);
+      for(int a = CI[c];a<CI[c+1];a++)
+      {
+        const int i = CV[a];
+        for(int e = a+1;e<CI[c+1];e++)
+        {
+          if(close(i,CV[e]))
+          {
+            P[b].push_back(make_pair(i,CV[e]));
+          }
+        }
+        for(int d = 0;d<dim;d++)
+        {
+          // Position within the cell in [0,1], with some slack for round-off
+          const double x = double(V(i,d))/width + shift - double(kc[d]);
+          side[d] |= (x <= 0.5+1./64. ? 1 : 0) | (x >= 0.5-1./64. ? 2 : 0);
+        }
+      }
+      for(int o = 0;o<num_nbrs;o++)
+      {
+        bool needed = o != num_nbrs/2;
+        for(int d = 0,r = o;d<dim && needed;d++,r /= 3)
+        {
+          const int s = r%3;
+          needed = s == 1 || (s == 0 && (side[d]&1)) || (s == 2 && (side[d]&2));
+          k[d] = kc[d] + s - 1;
+        }
+        if(!needed)
+        {
+          continue;
+        }
+        const int c2 = find_cell(&k[0]);
+        if(c2 <= c)
+        {
+          continue;
+        }
+        for(int a = CI[c];a<CI[c+1];a++)
+        {
+          const int i = CV[a];
+          for(int e = CI[c2];e<CI[c2+1];e++)
+          {
+            if(close(i,CV[e]))
+            {
+              P[b].push_back(make_pair(i,CV[e]));
+            }
+          }
+        }
+      }
+    }
+  }
+  // Union-find keeping the smallest index as root
+  root.resize(m);
+  for(int i = 0;i<m;i++)
+  {
+    root[i] = i;
+  }
+  const auto find = [&root](int i)->int
+  {
+    while(root[i] != i)
+    {
+      root[i] = root[root[i]];
+      i = root[i];
+    }
+    return i;
+  };
+  for(int b = 0;b<num_chunks;b++)
+  {
+    for(const auto & ij : P[b])
+    {
+      const int ri = find(ij.first);
+      const int rj = find(ij.second);
+      if(ri < rj)
+      {
+        root[rj] = ri;
+      }else if(rj < ri)
+      {
+        root[ri] = rj;
+      }
+    }
+  }
+  // Roots are smaller than their children so one forward pass flattens
+  for(int i = 0;i<m;i++)
+  {
+    root[i] = root[root[i]];
+  }
+}
 
 template <
   typename DerivedV, 
@@ -26,10 +347,26 @@ IGL_INLINE void igl::remove_duplicate_vertices(
 {
   if(epsilon > 0)
   {
-    Eigen::PlainObjectBase<DerivedV> rV,rSV;
-    round((V/(10.0*epsilon)).eval(),rV);
-    unique_rows(rV,rSV,SVI,SVJ);
-    slice(V,SVI,colon<int>(0,V.cols()-1),SV);
+    std::vector<int> root;
+    remove_duplicate_vertices_weld(V,epsilon,root);
+    const int m = V.rows();
+    // Clusters are numbered in order of their first vertex
+    int n = 0;
+    SVJ.resize(m,1);
+    for(int i = 0;i<m;i++)
+    {
+      SVJ(i) = root[i] == i ? n++ : SVJ(root[i]);
+    }
+    SVI.resize(n,1);
+    SV.resize(n,V.cols());
+    for(int i = 0;i<m;i++)
+    {
+      if(root[i] == i)
+      {
+        SVI(SVJ(i)) = i;
+        SV.row(SVJ(i)) = V.row(i);
+      }
+    }
   }else
   {
     unique_rows(V,SV,SVI,SVJ);
@@ -16,13 +16,20 @@ namespace igl
   //
   // Inputs:
   //   V  #V by dim list of vertex positions
-  //   epsilon  uniqueness tolerance (significant digit), can probably think of
-  //     this as a tolerance on L1 distance
+  //   epsilon  uniqueness tolerance: vertices within Euclidean distance
+  //     epsilon of each other are merged (transitively, so chains of close
+  //     vertices collapse to one). If epsilon <= 0 only exact duplicates are
+  //     merged.
   // Outputs:
   //   SV  #SV by dim new list of vertex positions
   //   SVI #V by 1 list of indices so SV = V(SVI,:) 
   //   SVJ #SV by 1 list of indices so V = SV(SVJ,:)
   //
+  // Note: If epsilon > 0 vertices are welded using a spatial hash of grid
+  // cells (no sorting), in parallel. SV then lists one vertex per cluster, the
+  // one with smallest index, in order of increasing index. Otherwise SV is
+  // sorted as by unique_rows.
+  //
   // Example:
   //   % Mesh in (V,F)
   //   [SV,SVI,SVJ] = remove_duplicate_vertices(V,1e-7);
@@ -13,8 +13,18 @@
 #include "colon.h"
 #include "IndexComparison.h"
 
+#include <algorithm>
+#include <type_traits>
 #include <vector>
 
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+// Integer matrices with more rows than this are radix sorted
+#ifndef IGL_SORTROWS_RADIX_MIN_ROWS
+#  define IGL_SORTROWS_RADIX_MIN_ROWS 10000
+#endif
+
 // Obsolete slower version converst to vector
 //template <typename DerivedX, typename DerivedIX>
 //IGL_INLINE void igl::sortrows(
@@ -49,6 +59,86 @@
 //  }
 //}
 
+// Stable LSD radix sort of the row indices of an integer matrix: one pass per
+// 11-bit digit (2048 buckets) of each column offset by the column minimum, so
+// ceil(bits(max-min)/11) passes per column (none for a constant column), last
+// column first. Each pass histograms and scatters blocks of rows in parallel.
+template <typename DerivedX, typename DerivedIX>
+static void sortrows_radix(
+  const Eigen::PlainObjectBase<DerivedX>& X,
+  Eigen::PlainObjectBase<DerivedIX>& IX,
+  std::true_type /*is_integral*/)
+{
+  typedef typename DerivedIX::Scalar Index;
+  typedef unsigned long long Key;
+  const int m = X.rows();
+  const int num_blocks = std::max(1,std::min(64,m/(1<<14)));
+  const int block = (m+num_blocks-1)/num_blocks;
+  std::vector<Index> idx(IX.data(),IX.data()+m),idx_tmp(m);
+  std::vector<Key> key(m),key_tmp(m);
+  std::vector<int> count(num_blocks*2048);
+  for(int c = X.cols()-1;c>=0;c--)
+  {
+    const Key mn = (Key)X.col(c).minCoeff();
+    const Key range = (Key)X.col(c).maxCoeff() - mn;
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+    for(int i = 0;i<m;i++)
+    {
+      key[i] = (Key)X(idx[i],c) - mn;
+    }
+    for(int shift = 0;shift<64 && (range>>shift) > 0;shift += 11)
+    {
+      std::fill(count.begin(),count.end(),0);
+#pragma omp parallel for if (num_blocks>1)
+      for(int b = 0;b<num_blocks;b++)
+      {
+        const int end = std::min(m,(b+1)*block);
+        for(int i = b*block;i<end;i++)
+        {
+          count[b*2048+((key[i]>>shift)&2047)]++;
+        }
+      }
+      // Exclusive prefix sum, digit-major then block-major keeps stability
+      int total = 0;
+      for(int d = 0;d<2048;d++)
+      {
+        for(int b = 0;b<num_blocks;b++)
+        {
+          const int t = count[b*2048+d];
+          count[b*2048+d] = total;
+          total += t;
+        }
+      }
+#pragma omp parallel for if (num_blocks>1)
+      for(int b = 0;b<num_blocks;b++)
+      {
+        const int end = std::min(m,(b+1)*block);
+        for(int i = b*block;i<end;i++)
+        {
+          const int j = count[b*2048+((key[i]>>shift)&2047)]++;
+          idx_tmp[j] = idx[i];
+          key_tmp[j] = key[i];
+        }
+      }
+      idx.swap(idx_tmp);
+      key.swap(key_tmp);
+    }
+  }
+  std::copy(idx.begin(),idx.end(),IX.data());
+}
+
+template <typename DerivedX, typename DerivedIX>
+static void sortrows_radix(
+  const Eigen::PlainObjectBase<DerivedX>& X,
+  Eigen::PlainObjectBase<DerivedIX>& IX,
+  std::false_type /*is_integral*/)
+{
+  std::sort(
+    IX.data(),
+    IX.data()+IX.size(),
+    igl::IndexRowLessThan<const Eigen::PlainObjectBase<DerivedX> & >(X));
+}
+
 template <typename DerivedX, typename DerivedIX>
 IGL_INLINE void igl::sortrows(
   const Eigen::PlainObjectBase<DerivedX>& X,
@@ -68,10 +158,20 @@ IGL_INLINE void igl::sortrows(
   {
     IX(i) = i;
   }
-  std::sort(
-    IX.data(),
-    IX.data()+IX.size(),
-    igl::IndexRowLessThan<const Eigen::PlainObjectBase<DerivedX> & >(X));
+  // ... except for large integer matrices where a (stable, parallel) radix
+  // sort over columns does beat comparison sorting.
+  if(X.rows() > IGL_SORTROWS_RADIX_MIN_ROWS)
+  {
+    sortrows_radix(X,IX,
+      std::integral_constant<bool,
+        std::is_integral<typename DerivedX::Scalar>::value>());
+  }else
+  {
+    std::sort(
+      IX.data(),
+      IX.data()+IX.size(),
+      igl::IndexRowLessThan<const Eigen::PlainObjectBase<DerivedX> & >(X));
+  }
   // if not ascending then reverse
   if(!ascending)
   {
@@ -26,6 +26,9 @@ namespace igl
   //     reference as X)
   //   I  m list of indices so that
   //     Y = X(I,:);
+  //
+  // Note: Integer matrices with many rows are sorted with a stable parallel
+  // radix sort, so ties keep their original order.
   template <typename DerivedX, typename DerivedI>
   IGL_INLINE void sortrows(
     const Eigen::PlainObjectBase<DerivedX>& X,
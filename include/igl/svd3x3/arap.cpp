@@ -18,6 +18,8 @@
 #include <igl/arap_rhs.h>
 #include <igl/repdiag.h>
 #include <igl/columnize.h>
+#include <igl/Timer.h>
+#include <igl/anderson_acceleration.h>
 #include "fit_rotations.h"
 #include <cassert>
 #include <iostream>
@@ -144,6 +146,7 @@ IGL_INLINE bool igl::arap_precomputation(
     data.K = (ref_map_dim * data.K).eval();
   }
   assert(data.K.rows() == data.n*data.dim);
+  data.Kr = data.K;
 
   SparseMatrix<double> Q = (-L).eval();
 
@@ -160,6 +163,7 @@ IGL_INLINE bool igl::arap_precomputation(
     data.vel = MatrixXd::Zero(n,data.dim);
   }
 
+  data.Q = Q;
   return min_quad_with_fixed_precompute(
     Q,b,SparseMatrix<double>(),true,data.solver_data);
 }
@@ -193,113 +197,229 @@ IGL_INLINE bool igl::arap_solve(
   {
     assert(U.cols() == data.dim && "U.cols() match data.dim");
   }
-  // changes each arap iteration
-  MatrixXd U_prev = U;
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  data.t_local = 0;
+  data.t_rhs = 0;
+  data.t_global = 0;
+  Timer timer;
+  // Size workspace (no-ops after the first call)
+  const int Rdim = data.dim;
+  // Number of rotations: #vertices or #elements
+  const int num_rots = data.K.cols()/Rdim/Rdim;
+  data.Udim.resize(n*data.dim,data.dim);
+  data.Bcol.resize(n*data.dim);
+  data.Bc.resize(data.dim);
+  data.bcc.resize(data.dim);
+  data.Uc.resize(data.dim);
+  for(int c = 0;c<data.dim;c++)
+  {
+    if(bc.size()>0)
+    {
+      data.bcc[c] = bc.col(c);
+    }else
+    {
+      data.bcc[c].resize(0);
+    }
+  }
   // doesn't change for fixed with_dynamics timestep
-  MatrixXd U0;
   if(data.with_dynamics)
   {
-    U0 = U_prev;
+    data.U0 = U;
+    assert(data.M.rows() == n &&
+      "No mass matrix. Call arap_precomputation if changing with_dynamics");
+    const double h = data.h;
+    assert(h != 0);
+    //Dl = 1./(h*h*h)*M*(-2.*V0 + Vm1) - fext;
+    // data.vel = (V0-Vm1)/h
+    // h*data.vel = (V0-Vm1)
+    // -h*data.vel = -V0+Vm1)
+    // -V0-h*data.vel = -2V0+Vm1
+    data.Dl = 1./(h*h)*data.M*(-data.U0 - h*data.vel) - data.f_ext;
+  }
+  // The energy is only needed for safeguarding acceleration and for early
+  // termination
+  const bool with_energy = data.with_anderson || data.energy_tol > 0;
+  if(data.with_anderson)
+  {
+    if(data.aa_data.DG.rows() != n*data.dim ||
+      data.aa_data.m != data.anderson_m)
+    {
+      anderson_acceleration_precompute(n*data.dim,data.anderson_m,data.aa_data);
+    }else
+    {
+      anderson_acceleration_reset(data.aa_data);
+    }
   }
+  // Whether U is an extrapolated (not yet safeguarded) iterate
+  bool accelerated = false;
+  bool converged = false;
+  double E_prev = 0, E_start = 0;
   while(iter < data.max_iter)
   {
-    U_prev = U;
-    // enforce boundary conditions exactly
-    for(int bi = 0;bi<bc.rows();bi++)
+    // changes each arap iteration
+    data.U_prev = U;
+    // Local step and right-hand side at U. Repeated once with the plain
+    // local/global iterate if an accelerated U increased the energy.
+    while(true)
     {
-      U.row(data.b(bi)) = bc.row(bi);
-    }
+      // enforce boundary conditions exactly
+      for(int bi = 0;bi<bc.rows();bi++)
+      {
+        U.row(data.b(bi)) = bc.row(bi);
+      }
 
-    const auto & Udim = U.replicate(data.dim,1);
-    assert(U.cols() == data.dim);
-    // As if U.col(2) was 0
-    MatrixXd S = data.CSM * Udim;
-    // THIS NORMALIZATION IS IMPORTANT TO GET SINGLE PRECISION SVD CODE TO WORK
-    // CORRECTLY.
-    S /= S.array().abs().maxCoeff();
+      timer.start();
+      assert(U.cols() == data.dim);
+      for(int d = 0;d<data.dim;d++)
+      {
+        data.Udim.block(d*n,0,n,data.dim) = U;
+      }
+      // As if U.col(2) was 0
+      data.S.noalias() = data.CSM * data.Udim;
+      // THIS NORMALIZATION IS IMPORTANT TO GET SINGLE PRECISION SVD CODE TO WORK
+      // CORRECTLY.
+      data.S /= data.S.array().abs().maxCoeff();
 
-    const int Rdim = data.dim;
-    MatrixXd R(Rdim,data.CSM.rows());
-    if(R.rows() == 2)
-    {
-      fit_rotations_planar(S,R);
-    }else
-    {
-      fit_rotations(S,true,R);
+      MatrixXd & R = data.R;
+      if(Rdim == 2)
+      {
+        fit_rotations_planar(data.S,R);
+      }else
+      {
+        fit_rotations(data.S,true,R);
 //#ifdef __SSE__ // fit_rotations_SSE will convert to float if necessary
 //      fit_rotations_SSE(S,R);
 //#else
 //      fit_rotations(S,true,R);
 //#endif
-    }
-    //for(int k = 0;k<(data.CSM.rows()/dim);k++)
-    //{
-    //  R.block(0,dim*k,dim,dim) = MatrixXd::Identity(dim,dim);
-    //}
+      }
+      //for(int k = 0;k<(data.CSM.rows()/dim);k++)
+      //{
+      //  R.block(0,dim*k,dim,dim) = MatrixXd::Identity(dim,dim);
+      //}
 
+      // distribute group rotations to vertices in each group
+      if(data.G.size() == 0)
+      {
+        columnize(R,num_rots,2,data.Rcol);
+      }else
+      {
+        data.eff_R.resize(Rdim,num_rots*Rdim);
+        for(int r = 0;r<num_rots;r++)
+        {
+          data.eff_R.block(0,Rdim*r,Rdim,Rdim) =
+            R.block(0,Rdim*data.G(r),Rdim,Rdim);
+        }
+        columnize(data.eff_R,num_rots,2,data.Rcol);
+      }
+      timer.stop();
+      data.t_local += timer.getElapsedTimeInSec();
 
-    // Number of rotations: #vertices or #elements
-    int num_rots = data.K.cols()/Rdim/Rdim;
-    // distribute group rotations to vertices in each group
-    MatrixXd eff_R;
-    if(data.G.size() == 0)
-    {
-      // copy...
-      eff_R = R;
-    }else
+      // Bcol = -K * Rcol, one independent row at a time
+      timer.start();
+      const int Krows = data.Kr.rows();
+      assert(Krows == data.n*data.dim);
+#pragma omp parallel for if (Krows>IGL_OMP_MIN_VALUE)
+      for(int i = 0;i<Krows;i++)
+      {
+        double Bi = 0;
+        for(SparseMatrix<double,RowMajor>::InnerIterator it(data.Kr,i);it;++it)
+        {
+          Bi -= it.value()*data.Rcol(it.col());
+        }
+        data.Bcol(i) = Bi;
+      }
+      for(int c = 0;c<data.dim;c++)
+      {
+        data.Bc[c] = data.Bcol.segment(c*n,n);
+        if(data.with_dynamics)
+        {
+          data.Bc[c] += data.Dl.col(c);
+        }
+      }
+      timer.stop();
+      data.t_rhs += timer.getElapsedTimeInSec();
+
+      if(!with_energy)
+      {
+        break;
+      }
+      // Energy of global step at U for the current rotations: 0.5*U'QU + U'B
+      double E = 0;
+#pragma omp parallel for reduction(+:E) if (n>IGL_OMP_MIN_VALUE)
+      for(int c = 0;c<data.dim;c++)
+      {
+        // Uc is free to use as scratch until the solve
+        data.Uc[c].noalias() = data.Q * U.col(c);
+        E += U.col(c).dot(0.5*data.Uc[c] + data.Bc[c]);
+      }
+      if(accelerated && E > E_prev)
+      {
+        // Reject extrapolation: fall back on the plain local/global iterate
+        U = data.U_default;
+        anderson_acceleration_reset(data.aa_data);
+        accelerated = false;
+        continue;
+      }
+      data.last_energy = E;
+      break;
+    }
+    if(with_energy)
     {
-      eff_R.resize(Rdim,num_rots*Rdim);
-      for(int r = 0;r<num_rots;r++)
+      if(iter == 0)
+      {
+        E_start = data.last_energy;
+      }else if(
+        data.energy_tol > 0 &&
+        E_prev-data.last_energy <= data.energy_tol*(E_start-data.last_energy))
       {
-        eff_R.block(0,Rdim*r,Rdim,Rdim) =
-          R.block(0,Rdim*data.G(r),Rdim,Rdim);
+        converged = true;
+        break;
       }
+      E_prev = data.last_energy;
     }
 
-    MatrixXd Dl;
-    if(data.with_dynamics)
+    if(data.with_anderson)
     {
-      assert(data.M.rows() == n &&
-        "No mass matrix. Call arap_precomputation if changing with_dynamics");
-      const double h = data.h;
-      assert(h != 0);
-      //Dl = 1./(h*h*h)*M*(-2.*V0 + Vm1) - fext;
-      // data.vel = (V0-Vm1)/h
-      // h*data.vel = (V0-Vm1)
-      // -h*data.vel = -V0+Vm1)
-      // -V0-h*data.vel = -2V0+Vm1
-      Dl = 1./(h*h)*data.M*(-U0 - h*data.vel) - data.f_ext;
+      data.aa_x = Map<const VectorXd>(U.data(),U.size());
     }
-
-    VectorXd Rcol;
-    columnize(eff_R,num_rots,2,Rcol);
-    VectorXd Bcol = -data.K * Rcol;
-    assert(Bcol.size() == data.n*data.dim);
+    // Coordinates are independent given the shared factorization
+    timer.start();
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
     for(int c = 0;c<data.dim;c++)
     {
-      VectorXd Uc,Bc,bcc,Beq;
-      Bc = Bcol.block(c*n,0,n,1);
-      if(data.with_dynamics)
-      {
-        Bc += Dl.col(c);
-      }
-      if(bc.size()>0)
-      {
-        bcc = bc.col(c);
-      }
       min_quad_with_fixed_solve(
         data.solver_data,
-        Bc,bcc,Beq,
-        Uc);
-      U.col(c) = Uc;
+        data.Bc[c],data.bcc[c],data.Beq,
+        data.Uc[c]);
+      U.col(c) = data.Uc[c];
+    }
+    timer.stop();
+    data.t_global += timer.getElapsedTimeInSec();
+
+    if(data.with_anderson)
+    {
+      data.U_default = U;
+      data.aa_g = Map<const VectorXd>(U.data(),U.size());
+      anderson_acceleration_solve(data.aa_data,data.aa_g,data.aa_x);
+      Map<VectorXd>(U.data(),U.size()) = data.aa_x;
+      accelerated = true;
     }
 
     iter++;
   }
+  data.iter = iter;
+  if(accelerated && !converged)
+  {
+    // Last extrapolation was never checked, return plain iterate
+    U = data.U_default;
+  }
   if(data.with_dynamics)
   {
     // Keep track of velocity for next time
-    data.vel = (U-U0)/data.h;
+    data.vel = (U-data.U0)/data.h;
   }
 
   return true;
@@ -9,9 +9,11 @@
 #define IGL_ARAP_H
 #include <igl/igl_inline.h>
 #include <igl/min_quad_with_fixed.h>
+#include <igl/anderson_acceleration.h>
 #include <igl/ARAPEnergyType.h>
 #include <Eigen/Core>
 #include <Eigen/Sparse>
+#include <vector>
 
 namespace igl
 {
@@ -27,11 +29,25 @@ namespace igl
     // vel  #V by dim list of velocities
     // h  dynamics time step
     // max_iter  maximum inner iterations
+    // with_anderson  whether to accelerate the local/global iterations using
+    //   Anderson acceleration (safeguarded by the energy)
+    // anderson_m  number of previous iterates used by Anderson acceleration
+    // energy_tol  stop before max_iter once an iteration decreases the energy
+    //   by less than energy_tol times the total decrease since the first
+    //   iteration (0 to always take max_iter iterations)
     // K  rhs pre-multiplier
+    // Kr  row-major copy of K (used to assemble the rhs in parallel)
     // M  mass matrix
+    // Q  quadratic coefficients of the global step (used to evaluate energy)
     // solver_data  quadratic solver data
     // b  list of boundary indices into V
     // dim  dimension being used for solving
+    // t_local  seconds spent fitting rotations during last arap_solve
+    // t_rhs  seconds spent assembling right-hand sides during last arap_solve
+    // t_global  seconds spent in linear solves during last arap_solve
+    // iter  number of iterations taken by last arap_solve
+    // last_energy  energy (up to an additive constant) of the last iterate
+    //   evaluated by arap_solve, an upper bound on the energy of the output
     int n;
     Eigen::VectorXi G;
     ARAPEnergyType energy;
@@ -39,11 +55,24 @@ namespace igl
     Eigen::MatrixXd f_ext,vel;
     double h;
     int max_iter;
-    Eigen::SparseMatrix<double> K,M;
+    bool with_anderson;
+    int anderson_m;
+    double energy_tol;
+    Eigen::SparseMatrix<double> K,M,Q;
+    Eigen::SparseMatrix<double,Eigen::RowMajor> Kr;
     Eigen::SparseMatrix<double> CSM;
     min_quad_with_fixed_data<double> solver_data;
     Eigen::VectorXi b;
     int dim;
+    double t_local,t_rhs,t_global;
+    int iter;
+    double last_energy;
+    // Workspace reused across iterations and calls to arap_solve so that
+    // iterations do not allocate (sized on first use)
+    Eigen::MatrixXd U_prev,U0,Udim,S,R,eff_R,Dl,U_default;
+    Eigen::VectorXd Rcol,Bcol,Beq,aa_x,aa_g;
+    std::vector<Eigen::VectorXd> Bc,bcc,Uc;
+    anderson_acceleration_data<double> aa_data;
       ARAPData():
         n(0),
         G(),
@@ -52,11 +81,20 @@ namespace igl
         f_ext(),
         h(1),
         max_iter(10),
+        with_anderson(false),
+        anderson_m(5),
+        energy_tol(0),
         K(),
+        Kr(),
         CSM(),
         solver_data(),
         b(),
-        dim(-1) // force this to be set by _precomputation
+        dim(-1), // force this to be set by _precomputation
+        t_local(0),
+        t_rhs(0),
+        t_global(0),
+        iter(0),
+        last_energy(0)
     {
     };
   };
@@ -31,6 +31,7 @@
 #include <igl/min_quad_dense.h>
 #include <igl/get_seconds.h>
 #include <igl/columnize.h>
+#include <igl/anderson_acceleration.h>
 
 // defined if no early exit is supported, i.e., always take a fixed number of iterations
 #define IGL_ARAP_DOF_FIXED_ITERATIONS_COUNT
@@ -687,6 +688,68 @@ IGL_INLINE bool igl::arap_dof_update(
   MatrixXS L_part1xyz((data.dim + 1) * data.m, data.dim);
   MatrixXS L_part1(data.dim * (data.dim + 1) * data.m, 1);
 
+  // Dynamics contribution to the right hand side does not change over
+  // iterations
+  MatrixXS L_part1_dyn;
+  MatrixXd temp2;
+  if(data.with_dynamics)
+  {
+    // Eigen can't parse this:
+    //L_part1_dyn = 
+    //  -(2.0/(data.h*data.h)) * data.Pi_1 * data.Mass_tilde * data.L0 +
+    //   (1.0/(data.h*data.h)) * data.Pi_1 * data.Mass_tilde * data.Lm1;
+    // -1.0 because we've moved these linear terms to the right hand side
+    //MatrixXS temp = -1.0 * 
+    //    ((-2.0/(data.h*data.h)) * data.L0.array() + 
+    //      (1.0/(data.h*data.h)) * data.Lm1.array()).matrix();
+    //MatrixXS temp = -1.0 * 
+    //    ( (-1.0/(data.h*data.h)) * data.L0.array() + 
+    //      (1.0/(data.h*data.h)) * data.Lm1.array()
+    //      (-1.0/(data.h*data.h)) * data.L0.array() + 
+    //      ).matrix();
+    //Lvel0 = (1.0/(data.h)) * data.Lm1.array() - data.L0.array();
+    MatrixXS temp = -1.0 * 
+        ( (-1.0/(data.h*data.h)) * data.L0.array() + 
+          (1.0/(data.h)) * data.Lvel0.array()
+          ).matrix();
+    MatrixXd temp_d = temp.template cast<double>();
+
+    MatrixXd temp_g = data.fgrav*(data.grav_mag*data.grav_dir);
+
+    assert(data.fext.rows() == temp_g.rows());
+    assert(data.fext.cols() == temp_g.cols());
+    temp2 = data.Mass_tilde * temp_d + temp_g + data.fext.template cast<double>();
+    MatrixXS temp2_f = temp2.template cast<SSCALAR>();
+    L_part1_dyn = data.Pi_1 * temp2_f;
+  }
+
+  // The energy is only needed for safeguarding acceleration and for early
+  // termination. The global step minimizes 0.5*L'*Qeff*L + L'*(0.5*M_KG*Rcol
+  // - temp2) subject to the linear constraints.
+  const bool with_energy = data.with_anderson || data.energy_tol > 0;
+  LbsMatrixType Qeff;
+  if(with_energy)
+  {
+    Qeff = data.Q;
+    if(data.with_dynamics)
+    {
+      Qeff += (1.0/(data.h*data.h))*data.Mass_tilde;
+    }
+  }
+  typedef Matrix<SSCALAR,Dynamic,1> VectorXS;
+  anderson_acceleration_data<SSCALAR> aa_data;
+  VectorXS aa_x,aa_g;
+  MatrixXS L_default;
+  if(data.with_anderson)
+  {
+    anderson_acceleration_precompute(L_SSCALAR.rows(),data.anderson_m,aa_data);
+  }
+  // Whether L_SSCALAR is an extrapolated (not yet safeguarded) iterate
+  bool accelerated = false;
+  bool converged = false;
+  double E = 0, E_prev = 0, E_start = 0;
+  VectorXd Ld,Rcold;
+
 #ifdef ARAP_GLOBAL_TIMING
     double timer_prepFinished = get_seconds_hires();
 #endif
@@ -705,65 +768,105 @@ IGL_INLINE bool igl::arap_dof_update(
 #ifndef IGL_ARAP_DOF_FIXED_ITERATIONS_COUNT
     L_prev = L_SSCALAR;
 #endif
-    ///////////////////////////////////////////////////////////////////////////
-    // Local step: Fix positions, fit rotations
-    ///////////////////////////////////////////////////////////////////////////    
+    // Local step at L_SSCALAR. Repeated once with the plain local/global
+    // iterate if an accelerated L_SSCALAR increased the energy.
+    while(true)
+    {
+      ///////////////////////////////////////////////////////////////////////////
+      // Local step: Fix positions, fit rotations
+      ///////////////////////////////////////////////////////////////////////////    
   
-    // Gather covariance matrices    
-
-    splitColumns(L_SSCALAR, data.m, data.dim, data.dim + 1, Lsep);
-
-    S = data.CSM * Lsep; 
-    // interestingly, this doesn't seem to be so slow, but
-    //MKL is still 2x faster (probably due to AVX)
-    //#ifdef IGL_ARAP_DOF_DOUBLE_PRECISION_SOLVE
-    //    MKL_matMatMult_double(S, data.CSM, Lsep);
-    //#else
-    //    MKL_matMatMult_single(S, data.CSM, Lsep);
-    //#endif
+      // Gather covariance matrices    
+
+      splitColumns(L_SSCALAR, data.m, data.dim, data.dim + 1, Lsep);
+
+      S = data.CSM * Lsep; 
+      // interestingly, this doesn't seem to be so slow, but
+      //MKL is still 2x faster (probably due to AVX)
+      //#ifdef IGL_ARAP_DOF_DOUBLE_PRECISION_SOLVE
+      //    MKL_matMatMult_double(S, data.CSM, Lsep);
+      //#else
+      //    MKL_matMatMult_single(S, data.CSM, Lsep);
+      //#endif
     
-    if(data.print_timings)
-    {
-      sec_covGather = get_seconds_hires();
-    }
+      if(data.print_timings)
+      {
+        sec_covGather = get_seconds_hires();
+      }
 
 #ifdef EXTREME_VERBOSE
-    cout<<"S=["<<endl<<S<<endl<<"];"<<endl;
+      cout<<"S=["<<endl<<S<<endl<<"];"<<endl;
 #endif
-    // Fit rotations to covariance matrices
-    if(data.effective_dim == 2)
-    {
-      fit_rotations_planar(S,R);
-    }else
-    {
+      // Fit rotations to covariance matrices
+      if(data.effective_dim == 2)
+      {
+        fit_rotations_planar(S,R);
+      }else
+      {
 #ifdef __SSE__ // fit_rotations_SSE will convert to float if necessary
-      fit_rotations_SSE(S,R);
+        fit_rotations_SSE(S,R);
 #else
-      fit_rotations(S,false,R);
+        fit_rotations(S,false,R);
 #endif
-    }
+      }
 
 #ifdef EXTREME_VERBOSE
-    cout<<"R=["<<endl<<R<<endl<<"];"<<endl;
+      cout<<"R=["<<endl<<R<<endl<<"];"<<endl;
 #endif  
 
-    if(data.print_timings)
+      if(data.print_timings)
+      {
+        sec_fitRotations = get_seconds_hires();
+      }
+  
+
+      // all this shuffling is retarded and not completely negligible
+      // time-wise; TODO: change fit_rotations_XXX so it returns R in the
+      // format ready for CSolveBlock1 multiplication
+      columnize(R, k, 2, Rcol);
+#ifdef EXTREME_VERBOSE
+      cout<<"Rcol=["<<endl<<Rcol<<endl<<"];"<<endl;
+#endif  
+
+      if(!with_energy)
+      {
+        break;
+      }
+      Ld = L_SSCALAR.col(0).template cast<double>();
+      Rcold = Rcol.template cast<double>();
+      E = Ld.dot(0.5*(Qeff*Ld) + 0.5*(data.M_KG*Rcold));
+      if(data.with_dynamics)
+      {
+        E -= Ld.dot(temp2.col(0));
+      }
+      if(accelerated && E > E_prev)
+      {
+        // Reject extrapolation: fall back on the plain local/global iterate
+        L_SSCALAR = L_default;
+        anderson_acceleration_reset(aa_data);
+        accelerated = false;
+        continue;
+      }
+      break;
+    }
+    if(with_energy)
     {
-      sec_fitRotations = get_seconds_hires();
+      if(iters == 0)
+      {
+        E_start = E;
+      }else if(data.energy_tol > 0 && E_prev-E <= data.energy_tol*(E_start-E))
+      {
+        converged = true;
+        break;
+      }
+      E_prev = E;
     }
-  
+
     ///////////////////////////////////////////////////////////////////////////
     // "Global" step: fix rotations per mesh vertex, solve for
     // linear transformations at handles
     ///////////////////////////////////////////////////////////////////////////
 
-    // all this shuffling is retarded and not completely negligible time-wise;
-    // TODO: change fit_rotations_XXX so it returns R in the format ready for
-    // CSolveBlock1 multiplication
-    columnize(R, k, 2, Rcol);
-#ifdef EXTREME_VERBOSE
-    cout<<"Rcol=["<<endl<<Rcol<<endl<<"];"<<endl;
-#endif  
     splitColumns(Rcol, k, data.dim, data.dim, Rxyz);
     
     if(data.print_timings)
@@ -781,44 +884,27 @@ IGL_INLINE bool igl::arap_dof_update(
 
     if(data.with_dynamics)
     {
-      // Consider reordering or precomputing matrix multiplications
-      MatrixXS L_part1_dyn(data.dim * (data.dim + 1) * data.m, 1);
-      // Eigen can't parse this:
-      //L_part1_dyn = 
-      //  -(2.0/(data.h*data.h)) * data.Pi_1 * data.Mass_tilde * data.L0 +
-      //   (1.0/(data.h*data.h)) * data.Pi_1 * data.Mass_tilde * data.Lm1;
-      // -1.0 because we've moved these linear terms to the right hand side
-      //MatrixXS temp = -1.0 * 
-      //    ((-2.0/(data.h*data.h)) * data.L0.array() + 
-      //      (1.0/(data.h*data.h)) * data.Lm1.array()).matrix();
-      //MatrixXS temp = -1.0 * 
-      //    ( (-1.0/(data.h*data.h)) * data.L0.array() + 
-      //      (1.0/(data.h*data.h)) * data.Lm1.array()
-      //      (-1.0/(data.h*data.h)) * data.L0.array() + 
-      //      ).matrix();
-      //Lvel0 = (1.0/(data.h)) * data.Lm1.array() - data.L0.array();
-      MatrixXS temp = -1.0 * 
-          ( (-1.0/(data.h*data.h)) * data.L0.array() + 
-            (1.0/(data.h)) * data.Lvel0.array()
-            ).matrix();
-      MatrixXd temp_d = temp.template cast<double>();
-
-      MatrixXd temp_g = data.fgrav*(data.grav_mag*data.grav_dir);
-
-      assert(data.fext.rows() == temp_g.rows());
-      assert(data.fext.cols() == temp_g.cols());
-      MatrixXd temp2 = data.Mass_tilde * temp_d + temp_g + data.fext.template cast<double>();
-      MatrixXS temp2_f = temp2.template cast<SSCALAR>();
-      L_part1_dyn = data.Pi_1 * temp2_f;
       L_part1.array() = L_part1.array() + L_part1_dyn.array();
     }
 
     //L_SSCALAR = L_part1 + L_part2and3;
     assert(L_SSCALAR.rows() == L_part1.rows() && L_SSCALAR.rows() == L_part2and3.rows());
+    if(data.with_anderson)
+    {
+      aa_x = L_SSCALAR.col(0);
+    }
     for (int i=0; i<L_SSCALAR.rows(); i++)
     {
       L_SSCALAR(i, 0) = L_part1(i, 0) + L_part2and3(i, 0);
     }
+    if(data.with_anderson)
+    {
+      L_default = L_SSCALAR;
+      aa_g = L_SSCALAR.col(0);
+      anderson_acceleration_solve(aa_data,aa_g,aa_x);
+      L_SSCALAR.col(0) = aa_x;
+      accelerated = true;
+    }
 
 #ifdef EXTREME_VERBOSE
     cout<<"L=["<<endl<<L<<endl<<"];"<<endl;
@@ -859,6 +945,11 @@ IGL_INLINE bool igl::arap_dof_update(
   }
 
 
+  if(accelerated && !converged)
+  {
+    // Last extrapolation was never checked, return plain iterate
+    L_SSCALAR = L_default;
+  }
   L = L_SSCALAR.template cast<double>();
   assert(L.cols() == 1);
 
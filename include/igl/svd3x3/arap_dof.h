@@ -131,6 +131,7 @@ namespace igl
   //     matrix entries) change by less than 'tol' the optimization terminates,
   //       0.75 (weak tolerance)
   //       0.0 (extreme tolerance)
+  //     (see also data.energy_tol and data.with_anderson)
   // Outputs:
   //   L  #handles * dim * dim+1 list of final optimized transformation entries,
   //     allowed to be the same as L
@@ -190,6 +191,16 @@ namespace igl
   
     // Print timings at each update
     bool print_timings;
+
+    // Whether to accelerate the local/global iterations of arap_dof_update
+    // using Anderson acceleration (safeguarded by the energy)
+    bool with_anderson;
+    // Number of previous iterates used by Anderson acceleration
+    int anderson_m;
+    // Stop arap_dof_update before max_iters once an iteration decreases the
+    // energy by less than energy_tol times the total decrease since the first
+    // iteration (0 to always take max_iters iterations)
+    double energy_tol;
   
     // Dynamics
     bool with_dynamics;
@@ -228,6 +239,9 @@ namespace igl
     // Default values
     ArapDOFData(): 
       energy(igl::ARAP_ENERGY_TYPE_SPOKES), 
+      with_anderson(false),
+      anderson_m(5),
+      energy_tol(0),
       with_dynamics(false),
       h(1),
       grav_dir(0,-1,0),
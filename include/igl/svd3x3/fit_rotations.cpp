@@ -30,12 +30,16 @@ IGL_INLINE void igl::fit_rotations(
   // resize output
   R.resize(dim,dim*nr); // hopefully no op (should be already allocated)
 
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
   //std::cout<<"S=["<<std::endl<<S<<std::endl<<"];"<<std::endl;
   //MatrixXd si(dim,dim);
-  Eigen::Matrix<typename DerivedS::Scalar,3,3> si;// = Eigen::Matrix3d::Identity();
-  // loop over number of rotations we're computing
+  // loop over number of rotations we're computing (independently)
+#pragma omp parallel for if (nr>IGL_OMP_MIN_VALUE)
   for(int r = 0;r<nr;r++)
   {
+    Eigen::Matrix<typename DerivedS::Scalar,3,3> si;// = Eigen::Matrix3d::Identity();
     // build this covariance matrix
     for(int i = 0;i<dim;i++)
     {
@@ -77,10 +81,14 @@ IGL_INLINE void igl::fit_rotations_planar(
   // resize output
   R.resize(dim,dim*nr); // hopefully no op (should be already allocated)
 
-  Eigen::Matrix<typename DerivedS::Scalar,2,2> si;
-  // loop over number of rotations we're computing
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  // loop over number of rotations we're computing (independently)
+#pragma omp parallel for if (nr>IGL_OMP_MIN_VALUE)
   for(int r = 0;r<nr;r++)
   {
+    Eigen::Matrix<typename DerivedS::Scalar,2,2> si;
     // build this covariance matrix
     for(int i = 0;i<2;i++)
     {
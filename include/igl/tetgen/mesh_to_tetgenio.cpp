@@ -7,9 +7,6 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "mesh_to_tetgenio.h"
 
-// IGL includes 
-#include <igl/matrix_to_list.h>
-
 // STL includes
 #include <cassert>
 
@@ -64,13 +61,43 @@ IGL_INLINE bool igl::mesh_to_tetgenio(
   const Eigen::PlainObjectBase<DerivedF>& F,
   tetgenio & in)
 {
-  using namespace igl;
-  using namespace std;
-  vector<vector<REAL> > vV;
-  vector<vector<int> > vF;
-  matrix_to_list(V,vV);
-  matrix_to_list(F,vF);
-  return mesh_to_tetgenio(vV,vF,in);
+  assert(V.cols() == 3 && "V should be #V by 3");
+  // all indices start from 0
+  in.firstnumber = 0;
+
+  in.numberofpoints = V.rows();
+  in.pointlist = new REAL[in.numberofpoints * 3];
+  // loop over points
+  for(int i = 0; i < in.numberofpoints; i++)
+  {
+    in.pointlist[i*3+0] = V(i,0);
+    in.pointlist[i*3+1] = V(i,1);
+    in.pointlist[i*3+2] = V(i,2);
+  }
+
+  in.numberoffacets = F.rows();
+  in.facetlist = new tetgenio::facet[in.numberoffacets];
+  in.facetmarkerlist = new int[in.numberoffacets];
+
+  // loop over face
+  for(int i = 0;i < in.numberoffacets; i++)
+  {
+    in.facetmarkerlist[i] = i;
+    tetgenio::facet * f = &in.facetlist[i];
+    f->numberofpolygons = 1;
+    f->polygonlist = new tetgenio::polygon[f->numberofpolygons];
+    f->numberofholes = 0;
+    f->holelist = NULL;
+    tetgenio::polygon * p = &f->polygonlist[0];
+    p->numberofvertices = F.cols();
+    p->vertexlist = new int[p->numberofvertices];
+    // loop around face
+    for(int j = 0;j < (int)F.cols(); j++)
+    {
+      p->vertexlist[j] = F(i,j);
+    }
+  }
+  return true;
 }
 
 #ifdef IGL_STATIC_LIBRARY
@@ -7,10 +7,8 @@
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "tetgenio_to_tetmesh.h"
 
-// IGL includes
-#include <igl/list_to_matrix.h>
-
 // STL includes
+#include <cassert>
 #include <iostream>
 
 IGL_INLINE bool igl::tetgenio_to_tetmesh(
@@ -63,8 +61,6 @@ IGL_INLINE bool igl::tetgenio_to_tetmesh(
   assert(max_index >= 0);
   assert(max_index < (int)V.size());
 
-  cout<<out.numberoftrifaces<<endl;
-
   // When would this not be 4?
   F.clear();
   // loop over tetrahedra
@@ -100,27 +96,61 @@ IGL_INLINE bool igl::tetgenio_to_tetmesh(
   Eigen::PlainObjectBase<DerivedT>& T,
   Eigen::PlainObjectBase<DerivedF>& F)
 {
-  using namespace igl;
   using namespace std;
-  vector<vector<REAL> > vV;
-  vector<vector<int> > vT;
-  bool success = tetgenio_to_tetmesh(out,vV,vT);
-  if(!success)
+  // process points
+  if(out.pointlist == NULL)
   {
+    cerr<<"^tetgenio_to_tetmesh Error: point list is NULL\n"<<endl;
     return false;
   }
-  bool V_rect = list_to_matrix(vV,V);
-  if(!V_rect)
+  V.resize(out.numberofpoints,3);
+  // loop over points
+  for(int i = 0;i < out.numberofpoints; i++)
   {
-    // igl::list_to_matrix(vV,V) already printed error message to std err
-    return false;
+    V(i,0) = out.pointlist[i*3+0];
+    V(i,1) = out.pointlist[i*3+1];
+    V(i,2) = out.pointlist[i*3+2];
   }
-  bool T_rect = list_to_matrix(vT,T);
-  if(!T_rect)
+
+  // process tets
+  if(out.tetrahedronlist == NULL)
   {
-    // igl::list_to_matrix(vT,T) already printed error message to std err
+    cerr<<"^tetgenio_to_tetmesh Error: tet list is NULL\n"<<endl;
     return false;
   }
+
+  // When would this not be 4?
+  assert(out.numberofcorners == 4);
+  T.resize(out.numberoftetrahedra,out.numberofcorners);
+  // loop over tetrahedra
+  for(int i = 0; i < out.numberoftetrahedra; i++)
+  {
+    for(int j = 0; j<out.numberofcorners; j++)
+    {
+      T(i,j) = out.tetrahedronlist[i * out.numberofcorners + j];
+    }
+  }
+  assert(T.size() == 0 || T.minCoeff() >= 0);
+  assert(T.size() == 0 || T.maxCoeff() < V.rows());
+
+  // marked facets
+  int nf = 0;
+  for(int i = 0; i < out.numberoftrifaces; i++)
+  {
+    nf += out.trifacemarkerlist[i]>=0;
+  }
+  F.resize(nf,3);
+  for(int i = 0, f = 0; i < out.numberoftrifaces; i++)
+  {
+    if(out.trifacemarkerlist[i]>=0)
+    {
+      for(int j = 0; j<3; j++)
+      {
+        F(f,j) = out.trifacelist[i * 3 + j];
+      }
+      f++;
+    }
+  }
   return true;
 }
 
@@ -130,11 +160,12 @@ IGL_INLINE bool igl::tetgenio_to_tetmesh(
   Eigen::PlainObjectBase<DerivedV>& V,
   Eigen::PlainObjectBase<DerivedT>& T)
 {
-  Eigen::PlainObjectBase<DerivedT> F;
+  Eigen::Matrix<typename DerivedT::Scalar,Eigen::Dynamic,3> F;
   return tetgenio_to_tetmesh(out,V,T,F);
 }
 
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template specialization
 template bool igl::tetgenio_to_tetmesh<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(tetgenio const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template bool igl::tetgenio_to_tetmesh<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(tetgenio const&, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
 #endif
@@ -10,12 +10,11 @@
 #include "tetgenio_to_tetmesh.h"
 
 // IGL includes 
-#include <igl/matrix_to_list.h>
-#include <igl/list_to_matrix.h>
-#include <igl/boundary_facets.h>
+#include <igl/get_seconds.h>
 
 // STL includes
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 IGL_INLINE int igl::tetrahedralize(
@@ -59,49 +58,223 @@ IGL_INLINE int igl::tetrahedralize(
   return 0;
 }
 
+namespace igl
+{
+  // Input arrays of a tetgenio owned here rather than by the tetgenio (whose
+  // destructor would free them), so that a worker can reuse them for many
+  // meshes instead of allocating every point list, facet and polygon again.
+  class TetgenioInputBuffers
+  {
+    private:
+      std::vector<REAL> points;
+      std::vector<tetgenio::facet> facets;
+      std::vector<tetgenio::polygon> polygons;
+      std::vector<int> corners;
+      std::vector<int> markers;
+    public:
+      // Point in at (V,F) stored in these buffers (see mesh_to_tetgenio)
+      template <typename DerivedV, typename DerivedF>
+      inline void attach(
+        const Eigen::PlainObjectBase<DerivedV>& V,
+        const Eigen::PlainObjectBase<DerivedF>& F,
+        tetgenio & in)
+      {
+        assert(V.cols() == 3 && "V should be #V by 3");
+        const int n = V.rows();
+        const int m = F.rows();
+        const int p = F.cols();
+        points.resize(n*3);
+        for(int i = 0;i<n;i++)
+        {
+          for(int d = 0;d<3;d++)
+          {
+            points[i*3+d] = V(i,d);
+          }
+        }
+        facets.resize(m);
+        polygons.resize(m);
+        corners.resize(m*p);
+        markers.resize(m);
+        for(int i = 0;i<m;i++)
+        {
+          markers[i] = i;
+          tetgenio::facet & f = facets[i];
+          f.numberofpolygons = 1;
+          f.polygonlist = &polygons[i];
+          f.numberofholes = 0;
+          f.holelist = NULL;
+          tetgenio::polygon & q = polygons[i];
+          q.numberofvertices = p;
+          q.vertexlist = &corners[i*p];
+          for(int j = 0;j<p;j++)
+          {
+            corners[i*p+j] = F(i,j);
+          }
+        }
+        // all indices start from 0
+        in.firstnumber = 0;
+        in.numberofpoints = n;
+        in.pointlist = points.data();
+        in.numberoffacets = m;
+        in.facetlist = facets.data();
+        in.facetmarkerlist = markers.data();
+      }
+      // Detach in from these buffers before it is destroyed
+      inline void detach(tetgenio & in)
+      {
+        in.numberofpoints = 0;
+        in.pointlist = NULL;
+        in.numberoffacets = 0;
+        in.facetlist = NULL;
+        in.facetmarkerlist = NULL;
+      }
+  };
+}
+
+// Parse tetgen switches once so they can be reused
+static bool tetrahedralize_parse(
+  const std::string & switches,
+  tetgenbehavior & b)
+{
+  std::vector<char> cswitches(switches.begin(),switches.end());
+  cswitches.push_back('\0');
+  return b.parse_commandline(cswitches.data());
+}
+
+// Tetrahedralize (V,F) with parsed switches b using buffers for the input.
+// wait is set to the seconds spent waiting for other threads' TetGen runs.
 template <
   typename DerivedV, 
   typename DerivedF, 
   typename DerivedTV, 
   typename DerivedTT, 
   typename DerivedTF>
-IGL_INLINE int igl::tetrahedralize(
+static int tetrahedralize_run(
+  const tetgenbehavior & b,
   const Eigen::PlainObjectBase<DerivedV>& V,
   const Eigen::PlainObjectBase<DerivedF>& F,
-  const std::string switches,
+  igl::TetgenioInputBuffers & buffers,
   Eigen::PlainObjectBase<DerivedTV>& TV,
   Eigen::PlainObjectBase<DerivedTT>& TT,
-  Eigen::PlainObjectBase<DerivedTF>& TF)
+  Eigen::PlainObjectBase<DerivedTF>& TF,
+  double & wait)
 {
-  using namespace igl;
   using namespace std;
-  vector<vector<REAL> > vV,vTV;
-  vector<vector<int> > vF,vTT,vTF;
-  matrix_to_list(V,vV);
-  matrix_to_list(F,vF);
-  int e = tetrahedralize(vV,vF,switches,vTV,vTT,vTF);
-  if(e == 0)
+  wait = 0;
+  // tetgen frees its memory twice when it rejects an empty point set
+  if(V.rows() == 0 || F.rows() == 0)
+  {
+    return -1;
+  }
+  tetgenio in,out;
+  buffers.attach(V,F,in);
+  // tetgen may change the switches it is given
+  tetgenbehavior bc = b;
+  bool crashed = false;
+  const double t0 = igl::get_seconds();
+  // TetGen's robust predicates keep global state (see exactinit)
+#pragma omp critical(igl_tetrahedralize)
   {
-    bool TV_rect = list_to_matrix(vTV,TV);
-    if(!TV_rect)
+    wait = igl::get_seconds()-t0;
+    try
     {
-      return false;
-    }
-    bool TT_rect = list_to_matrix(vTT,TT);
-    if(!TT_rect)
+      ::tetrahedralize(&bc,&in,&out);
+    }catch(int)
     {
-      return false;
+      crashed = true;
     }
-    bool TF_rect = list_to_matrix(vTF,TF);
-    if(!TF_rect)
+  }
+  buffers.detach(in);
+  if(crashed)
+  {
+    cerr<<"^"<<__FUNCTION__<<": TETGEN CRASHED... KABOOOM!!!"<<endl;
+    return 1;
+  }
+  if(out.numberoftetrahedra == 0)
+  {
+    cerr<<"^"<<__FUNCTION__<<": Tetgen failed to create tets"<<endl;
+    return 2;
+  }
+  if(!igl::tetgenio_to_tetmesh(out,TV,TT,TF))
+  {
+    return -1;
+  }
+  return 0;
+}
+
+template <
+  typename DerivedV, 
+  typename DerivedF, 
+  typename DerivedTV, 
+  typename DerivedTT, 
+  typename DerivedTF>
+IGL_INLINE int igl::tetrahedralize(
+  const Eigen::PlainObjectBase<DerivedV>& V,
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  const std::string switches,
+  Eigen::PlainObjectBase<DerivedTV>& TV,
+  Eigen::PlainObjectBase<DerivedTT>& TT,
+  Eigen::PlainObjectBase<DerivedTF>& TF)
+{
+  tetgenbehavior b;
+  if(!tetrahedralize_parse(switches,b))
+  {
+    return 1;
+  }
+  TetgenioInputBuffers buffers;
+  double wait;
+  return tetrahedralize_run(b,V,F,buffers,TV,TT,TF,wait);
+}
+
+template <
+  typename DerivedV, 
+  typename DerivedF, 
+  typename DerivedTV, 
+  typename DerivedTT, 
+  typename DerivedTF>
+IGL_INLINE void igl::tetrahedralize(
+  const std::vector<DerivedV> & V,
+  const std::vector<DerivedF> & F,
+  const std::string switches,
+  std::vector<DerivedTV> & TV,
+  std::vector<DerivedTT> & TT,
+  std::vector<DerivedTF> & TF,
+  std::vector<int> & status,
+  std::vector<double> & seconds)
+{
+  using namespace std;
+  assert(V.size() == F.size() && "V and F should list the same parts");
+  const int np = V.size();
+  TV.resize(np);
+  TT.resize(np);
+  TF.resize(np);
+  seconds.assign(np,0);
+  tetgenbehavior b;
+  if(!tetrahedralize_parse(switches,b))
+  {
+    status.assign(np,1);
+    return;
+  }
+  status.assign(np,-1);
+#pragma omp parallel
+  {
+    // this worker's buffers, reused for all of its parts
+    TetgenioInputBuffers buffers;
+#pragma omp for schedule(dynamic)
+    for(int p = 0;p<np;p++)
     {
-      return false;
+      const double t0 = get_seconds();
+      double wait;
+      status[p] =
+        tetrahedralize_run(b,V[p],F[p],buffers,TV[p],TT[p],TF[p],wait);
+      // not counting the wait for other parts' TetGen runs
+      seconds[p] = get_seconds()-t0-wait;
     }
   }
-  return e;
 }
 
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template specialization
 template int igl::tetrahedralize<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, std::basic_string<char, std::char_traits<char>, std::allocator<char> >, Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> >&);
+template void igl::tetrahedralize<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1> >(std::vector<Eigen::Matrix<double, -1, -1, 0, -1, -1>, std::allocator<Eigen::Matrix<double, -1, -1, 0, -1, -1> > > const&, std::vector<Eigen::Matrix<int, -1, -1, 0, -1, -1>, std::allocator<Eigen::Matrix<int, -1, -1, 0, -1, -1> > > const&, std::basic_string<char, std::char_traits<char>, std::allocator<char> >, std::vector<Eigen::Matrix<double, -1, -1, 0, -1, -1>, std::allocator<Eigen::Matrix<double, -1, -1, 0, -1, -1> > >&, std::vector<Eigen::Matrix<int, -1, -1, 0, -1, -1>, std::allocator<Eigen::Matrix<int, -1, -1, 0, -1, -1> > >&, std::vector<Eigen::Matrix<int, -1, -1, 0, -1, -1>, std::allocator<Eigen::Matrix<int, -1, -1, 0, -1, -1> > >&, std::vector<int, std::allocator<int> >&, std::vector<double, std::allocator<double> >&);
 #endif
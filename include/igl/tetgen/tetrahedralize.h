@@ -63,6 +63,43 @@ namespace igl
     Eigen::PlainObjectBase<DerivedTV>& TV,
     Eigen::PlainObjectBase<DerivedTT>& TT,
     Eigen::PlainObjectBase<DerivedTF>& TF);
+
+  // Mesh the interiors of many independent surface meshes (e.g. the parts of
+  // an assembly) with the same tetgen options. Switches are parsed once and
+  // parts are distributed over a pool of workers, each converting directly
+  // between Eigen matrices and tetgenio arrays it reuses for all of its
+  // parts.
+  //
+  // Note: TetGen's robust predicates keep global state which every run
+  // re-initializes, so the TetGen runs themselves are serialized; conversion
+  // and setup of different parts overlap.
+  //
+  // Inputs:
+  //   V  #parts list of #V by 3 vertex position lists
+  //   F  #parts list of #F by 3 lists of polygon face indices into V
+  //   switches  string of tetgen options (see above)
+  // Outputs:
+  //   TV  #parts list of #TV by 3 vertex position lists
+  //   TT  #parts list of #T by 4 lists of tet face indices
+  //   TF  #parts list of #TF by 3 lists of triangle face indices
+  //   status  #parts list of return statuses (see above)
+  //   seconds  #parts list of wall-clock seconds spent on each part, not
+  //     counting the wait for other parts' TetGen runs
+  template <
+    typename DerivedV, 
+    typename DerivedF, 
+    typename DerivedTV, 
+    typename DerivedTT, 
+    typename DerivedTF>
+  IGL_INLINE void tetrahedralize(
+    const std::vector<DerivedV> & V,
+    const std::vector<DerivedF> & F,
+    const std::string switches,
+    std::vector<DerivedTV> & TV,
+    std::vector<DerivedTT> & TT,
+    std::vector<DerivedTF> & TF,
+    std::vector<int> & status,
+    std::vector<double> & seconds);
 }
 
 
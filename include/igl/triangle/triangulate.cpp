@@ -6,6 +6,9 @@
 // v. 2.0. If a copy of the MPL was not distributed with this file, You can
 // obtain one at http://mozilla.org/MPL/2.0/.
 #include "triangulate.h"
+#include <cassert>
+#include <cstdlib>
+#include <vector>
 #ifdef ANSI_DECLARATORS
 #  define IGL_PREVIOUSLY_DEFINED_ANSI_DECLARATORS ANSI_DECLARATORS
 #endif
@@ -42,6 +45,99 @@ extern "C"
 #  undef VOID
 #endif
 
+namespace igl
+{
+  // Input arrays of a triangulateio owned here, so that a worker can reuse
+  // them for many polygons instead of allocating them for every call.
+  class TriangulateioInputBuffers
+  {
+    private:
+      std::vector<double> points;
+      std::vector<int> point_markers;
+      std::vector<int> segments;
+      std::vector<int> segment_markers;
+      std::vector<double> holes;
+    public:
+      // Point in at (V,E,H) stored in these buffers
+      inline void attach(
+        const Eigen::MatrixXd& V,
+        const Eigen::MatrixXi& E,
+        const Eigen::MatrixXd& H,
+        triangulateio & in)
+      {
+        assert(V.cols() == 2);
+        points.resize(V.rows()*2);
+        for (int i=0;i<V.rows();++i)
+          for (int j=0;j<2;++j)
+            points[i*2+j] = V(i,j);
+        point_markers.assign(V.rows(),1);
+        segments.resize(E.rows()*2);
+        for (int i=0;i<E.rows();++i)
+          for (int j=0;j<2;++j)
+            segments[i*2+j] = E(i,j);
+        segment_markers.assign(E.rows(),1);
+        holes.resize(H.rows()*2);
+        for (int i=0;i<H.rows();++i)
+          for (int j=0;j<2;++j)
+            holes[i*2+j] = H(i,j);
+
+        in.numberofpoints = V.rows();
+        in.pointlist = points.data();
+        in.numberofpointattributes = 0;
+        in.pointattributelist = NULL;
+        in.pointmarkerlist = point_markers.data();
+
+        in.trianglelist = NULL;
+        in.numberoftriangles = 0;
+        in.numberofcorners = 0;
+        in.numberoftriangleattributes = 0;
+        in.triangleattributelist = NULL;
+        in.trianglearealist = NULL;
+
+        in.numberofsegments = E.rows();
+        in.segmentlist = segments.data();
+        in.segmentmarkerlist = segment_markers.data();
+
+        in.numberofholes = H.rows();
+        in.holelist = holes.data();
+        in.numberofregions = 0;
+        in.regionlist = NULL;
+      }
+  };
+}
+
+// Call triangle on (V,E,H) using buffers for the input. The caller owns (and
+// must free) out.pointlist, out.trianglelist and out.segmentlist.
+static void triangulate_run(
+  const std::string & full_flags,
+  const Eigen::MatrixXd& V,
+  const Eigen::MatrixXi& E,
+  const Eigen::MatrixXd& H,
+  igl::TriangulateioInputBuffers & buffers,
+  triangulateio & out)
+{
+  triangulateio in;
+  buffers.attach(V,E,H,in);
+  out.numberofpoints = 0;
+  out.numberoftriangles = 0;
+  out.pointlist = NULL;
+  out.trianglelist = NULL;
+  out.segmentlist = NULL;
+  // Triangle resets its random seed and exact arithmetic constants (see
+  // exactinit) in globals on every call
+#pragma omp critical(igl_triangulate)
+  {
+    ::triangulate(const_cast<char*>(full_flags.c_str()), &in, &out, 0);
+  }
+}
+
+static void triangulate_free(triangulateio & out)
+{
+  free(out.pointlist);
+  free(out.trianglelist);
+  free(out.segmentlist);
+}
+
 IGL_INLINE void igl::triangulate(
   const Eigen::MatrixXd& V,
   const Eigen::MatrixXi& E,
@@ -56,61 +152,10 @@ IGL_INLINE void igl::triangulate(
   // Prepare the flags
   string full_flags = flags + "pzBV";
 
-  // Prepare the input struct
-  triangulateio in;
-
-  assert(V.cols() == 2);
-
-  in.numberofpoints = V.rows();
-  in.pointlist = (double*)calloc(V.rows()*2,sizeof(double));
-  for (unsigned i=0;i<V.rows();++i)
-    for (unsigned j=0;j<2;++j)
-      in.pointlist[i*2+j] = V(i,j);
-
-  in.numberofpointattributes = 0;
-  in.pointmarkerlist = (int*)calloc(V.rows(),sizeof(int));
-   for (unsigned i=0;i<V.rows();++i)
-     in.pointmarkerlist[i] = 1;
-
-  in.trianglelist = NULL;
-  in.numberoftriangles = 0;
-  in.numberofcorners = 0;
-  in.numberoftriangleattributes = 0;
-  in.triangleattributelist = NULL;
-
-  in.numberofsegments = E.rows();
-  in.segmentlist = (int*)calloc(E.rows()*2,sizeof(int));
-  for (unsigned i=0;i<E.rows();++i)
-    for (unsigned j=0;j<2;++j)
-      in.segmentlist[i*2+j] = E(i,j);
-  in.segmentmarkerlist = (int*)calloc(E.rows(),sizeof(int));
-  for (unsigned i=0;i<E.rows();++i)
-    in.segmentmarkerlist[i] = 1;
-
-  in.numberofholes = H.rows();
-  in.holelist = (double*)calloc(H.rows()*2,sizeof(double));
-  for (unsigned i=0;i<H.rows();++i)
-    for (unsigned j=0;j<2;++j)
-      in.holelist[i*2+j] = H(i,j);
-  in.numberofregions = 0;
-
-  // Prepare the output struct
-  triangulateio out;
-
-  out.pointlist = NULL;
-  out.trianglelist = NULL;
-  out.segmentlist = NULL;
-
   // Call triangle
-  ::triangulate(const_cast<char*>(full_flags.c_str()), &in, &out, 0);
-
-  // Cleanup in
-  free(in.pointlist);
-  free(in.pointmarkerlist);
-  free(in.segmentlist);
-  free(in.segmentmarkerlist);
-  free(in.holelist);
-
+  TriangulateioInputBuffers buffers;
+  triangulateio out;
+  triangulate_run(full_flags,V,E,H,buffers,out);
 
   // Return the mesh
   V2.resize(out.numberofpoints,2);
@@ -124,10 +169,74 @@ IGL_INLINE void igl::triangulate(
       F2(i,j) = out.trianglelist[i*3+j];
 
   // Cleanup out
-  free(out.pointlist);
-  free(out.trianglelist);
-  free(out.segmentlist);
+  triangulate_free(out);
+}
 
+IGL_INLINE void igl::triangulate(
+  const std::vector<Eigen::MatrixXd>& V,
+  const std::vector<Eigen::MatrixXi>& E,
+  const std::vector<Eigen::MatrixXd>& H,
+  const std::string flags,
+  Eigen::MatrixXd& V2,
+  Eigen::MatrixXi& F2,
+  Eigen::VectorXi& VO,
+  Eigen::VectorXi& FO)
+{
+  using namespace std;
+  using namespace Eigen;
+  assert(V.size() == E.size() && "V and E should list the same polygons");
+  assert(H.empty() || H.size() == V.size());
+  const int np = V.size();
+  const string full_flags = flags + "pzBQ";
+  const MatrixXd no_holes(0,2);
+
+  // Triangle's outputs are kept until the concatenated mesh is sized
+  vector<triangulateio> out(np);
+#pragma omp parallel
+  {
+    // this worker's buffers, reused for all of its polygons
+    TriangulateioInputBuffers buffers;
+#pragma omp for schedule(dynamic,16)
+    for(int p = 0;p<np;p++)
+    {
+      // triangle exits on fewer than three vertices
+      if(V[p].rows() < 3)
+      {
+        out[p].numberofpoints = 0;
+        out[p].numberoftriangles = 0;
+        out[p].pointlist = NULL;
+        out[p].trianglelist = NULL;
+        out[p].segmentlist = NULL;
+        continue;
+      }
+      triangulate_run(
+        full_flags,V[p],E[p],H.empty()?no_holes:H[p],buffers,out[p]);
+    }
+  }
+
+  // Offsets of each polygon's vertices and faces
+  VO.resize(np+1);
+  FO.resize(np+1);
+  VO(0) = 0;
+  FO(0) = 0;
+  for(int p = 0;p<np;p++)
+  {
+    VO(p+1) = VO(p) + out[p].numberofpoints;
+    FO(p+1) = FO(p) + out[p].numberoftriangles;
+  }
+  V2.resize(VO(np),2);
+  F2.resize(FO(np),3);
+#pragma omp parallel for schedule(dynamic,16)
+  for(int p = 0;p<np;p++)
+  {
+    for(int i = 0;i<out[p].numberofpoints;i++)
+      for(int j = 0;j<2;j++)
+        V2(VO(p)+i,j) = out[p].pointlist[i*2+j];
+    for(int i = 0;i<out[p].numberoftriangles;i++)
+      for(int j = 0;j<3;j++)
+        F2(FO(p)+i,j) = VO(p)+out[p].trianglelist[i*3+j];
+    triangulate_free(out[p]);
+  }
 }
 
 #ifdef IGL_STATIC_LIBRARY
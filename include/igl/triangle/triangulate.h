@@ -9,6 +9,7 @@
 #define IGL_TRIANGULATE_H
 #include <igl/igl_inline.h>
 #include <string>
+#include <vector>
 #include <Eigen/Core>
 
 namespace igl
@@ -33,6 +34,36 @@ namespace igl
     const std::string flags,
     Eigen::MatrixXd& V2,
     Eigen::MatrixXi& F2);
+  // Triangulate the interiors of many independent polygons at once. Input
+  // conversion and output assembly run in parallel with buffers reused per
+  // thread; the calls to triangle itself are serialized, since triangle keeps
+  // its state in globals.
+  //
+  // Inputs:
+  //   V  #P list of #V[p] by 2 lists of 2D vertex positions
+  //   E  #P list of #E[p] by 2 lists of vertex ids into V[p] forming the
+  //     boundary of each polygon
+  //   H  #P list of #H[p] by 2 lists of hole points, or empty for no holes
+  //   flags  string of options pass to triangle (see triangle documentation)
+  // Outputs:
+  //   V2  #V2 by 2  coordinates of the vertices of all triangulations
+  //   F2  #F2 by 3  list of indices into V2 forming all faces
+  //   VO  #P+1 list of offsets so that rows VO(p) to VO(p+1)-1 of V2 belong
+  //     to polygon p
+  //   FO  #P+1 list of offsets so that rows FO(p) to FO(p+1)-1 of F2 belong
+  //     to polygon p
+  //
+  // Polygons with fewer than 3 vertices produce no output.
+  //
+  IGL_INLINE void triangulate(
+    const std::vector<Eigen::MatrixXd>& V,
+    const std::vector<Eigen::MatrixXi>& E,
+    const std::vector<Eigen::MatrixXd>& H,
+    const std::string flags,
+    Eigen::MatrixXd& V2,
+    Eigen::MatrixXi& F2,
+    Eigen::VectorXi& VO,
+    Eigen::VectorXi& FO);
 
 }
 
@@ -13,6 +13,69 @@
 #include <algorithm>
 #include <iostream>
 
+// Same result as sorting TTT (see triangle_triangle_adjacency_preprocess)
+// but using flat arrays: half-edges are bucketed by their smaller vertex with
+// a counting sort and each (small) bucket is sorted independently.
+template <typename DerivedF, typename DerivedTT, typename DerivedTTi>
+static void triangle_triangle_adjacency_flat(
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  Eigen::PlainObjectBase<DerivedTT>& TT,
+  Eigen::PlainObjectBase<DerivedTTi>& TTi)
+{
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+  const int m = F.rows();
+  const int c = F.cols();
+  const int n = F.size() == 0 ? 0 : F.maxCoeff()+1;
+  std::vector<int> offset(n+1,0);
+  for(int f=0;f<m;++f)
+  {
+    for(int i=0;i<c;++i)
+    {
+      offset[std::min(F(f,i),F(f,(i+1)%c))+1]++;
+    }
+  }
+  for(int v=0;v<n;++v)
+  {
+    offset[v+1] += offset[v];
+  }
+  // (larger vertex, half-edge index f*c+i) in increasing half-edge order
+  std::vector<std::pair<int,int> > H(m*c);
+  {
+    std::vector<int> next(offset.begin(),offset.end()-1);
+    for(int f=0;f<m;++f)
+    {
+      for(int i=0;i<c;++i)
+      {
+        int v1 = F(f,i);
+        int v2 = F(f,(i+1)%c);
+        if (v1 > v2) std::swap(v1,v2);
+        H[next[v1]++] = std::make_pair(v2,f*c+i);
+      }
+    }
+  }
+  TT.setConstant(m,c,-1);
+  TTi.setConstant(m,c,-1);
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(int v=0;v<n;++v)
+  {
+    std::sort(H.begin()+offset[v],H.begin()+offset[v+1]);
+    for(int j=offset[v]+1;j<offset[v+1];++j)
+    {
+      if(H[j-1].first == H[j].first)
+      {
+        const int f1 = H[j-1].second/c, i1 = H[j-1].second%c;
+        const int f2 = H[j].second/c, i2 = H[j].second%c;
+        TT(f1,i1) = f2;
+        TT(f2,i2) = f1;
+        TTi(f1,i1) = i2;
+        TTi(f2,i2) = i1;
+      }
+    }
+  }
+}
+
 template <typename Scalar, typename Index>
 IGL_INLINE void igl::triangle_triangle_adjacency_preprocess(
     const Eigen::PlainObjectBase<Scalar>& /*V*/,
@@ -27,6 +90,7 @@ IGL_INLINE void igl::triangle_triangle_adjacency_preprocess(
     const Eigen::PlainObjectBase<Index>& F,
     std::vector<std::vector<int> >& TTT)
 {
+  TTT.reserve(TTT.size()+F.size());
   for(int f=0;f<F.rows();++f)
     for (int i=0;i<F.cols();++i)
     {
@@ -86,15 +150,12 @@ IGL_INLINE void igl::triangle_triangle_adjacency_extractTTi(
 
 // Compute triangle-triangle adjacency
 template <typename Scalar, typename Index>
-IGL_INLINE void igl::triangle_triangle_adjacency(const Eigen::PlainObjectBase<Scalar>& V,
+IGL_INLINE void igl::triangle_triangle_adjacency(const Eigen::PlainObjectBase<Scalar>& /*V*/,
                         const Eigen::PlainObjectBase<Index>& F,
                         Eigen::PlainObjectBase<Index>& TT)
 {
-  //assert(igl::is_edge_manifold(V,F));
-  std::vector<std::vector<int> > TTT;
-
-  triangle_triangle_adjacency_preprocess(V,F,TTT);
-  triangle_triangle_adjacency_extractTT(F,TTT,TT);
+  Index TTi;
+  triangle_triangle_adjacency_flat(F,TT,TTi);
 }
 
 // Compute triangle-triangle adjacency with indices
@@ -105,11 +166,7 @@ IGL_INLINE void igl::triangle_triangle_adjacency(
   Eigen::PlainObjectBase<Index>& TT,
   Eigen::PlainObjectBase<Index>& TTi)
 {
-  //assert(igl::is_edge_manifold(V,F));
-  std::vector<std::vector<int> > TTT;
-  triangle_triangle_adjacency_preprocess(F,TTT);
-  triangle_triangle_adjacency_extractTT(F,TTT,TT);
-  triangle_triangle_adjacency_extractTTi(F,TTT,TTi);
+  triangle_triangle_adjacency_flat(F,TT,TTi);
 }
 
 // Compute triangle-triangle adjacency with indices
@@ -120,10 +177,7 @@ IGL_INLINE void igl::triangle_triangle_adjacency(
   Eigen::PlainObjectBase<DerivedTTi>& TTi)
 {
   //assert(igl::is_edge_manifold(V,F));
-  std::vector<std::vector<int> > TTT;
-  triangle_triangle_adjacency_preprocess(F,TTT);
-  triangle_triangle_adjacency_extractTT(F,TTT,TT);
-  triangle_triangle_adjacency_extractTTi(F,TTT,TTi);
+  triangle_triangle_adjacency_flat(F,TT,TTi);
 }
 
 template <
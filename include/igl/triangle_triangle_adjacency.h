@@ -51,7 +51,8 @@ namespace igl
     Eigen::PlainObjectBase<DerivedTTi>& TTi);
 
 
-  // Preprocessing
+  // Preprocessing (the Eigen outputs above are computed with flat arrays
+  // instead, these are kept for callers that need TTT)
   template <typename Scalar, typename Index>
   IGL_INLINE void triangle_triangle_adjacency_preprocess(
     const Eigen::PlainObjectBase<Scalar>& V,
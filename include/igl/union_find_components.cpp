@@ -0,0 +1,168 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#include "union_find_components.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+
+// Parent pointers always point to a smaller index, so the root of each set is
+// its smallest element and concurrent links can never form a cycle.
+
+// Root of the set containing i, halving the path on the way
+static int union_find_components_root(
+  std::vector<std::atomic<int> > & P,
+  int i)
+{
+  while(true)
+  {
+    int p = P[i].load(std::memory_order_relaxed);
+    if(p == i)
+    {
+      return i;
+    }
+    const int g = P[p].load(std::memory_order_relaxed);
+    if(g != p)
+    {
+      // May fail if another thread got there first, which is fine
+      P[i].compare_exchange_weak(p,g,std::memory_order_relaxed);
+    }
+    i = g;
+  }
+}
+
+// Merge the sets containing i and j by linking the larger root below the
+// smaller one, retrying if the larger root was linked meanwhile
+static void union_find_components_unite(
+  std::vector<std::atomic<int> > & P,
+  int i,
+  int j)
+{
+  while(true)
+  {
+    i = union_find_components_root(P,i);
+    j = union_find_components_root(P,j);
+    if(i == j)
+    {
+      return;
+    }
+    if(i < j)
+    {
+      std::swap(i,j);
+    }
+    int expected = i;
+    if(P[i].compare_exchange_strong(expected,j))
+    {
+      return;
+    }
+  }
+}
+
+// Label the sets of P in order of their roots
+template <typename DerivedC, typename Derivedcounts>
+static void union_find_components_label(
+  std::vector<std::atomic<int> > & P,
+  Eigen::PlainObjectBase<DerivedC> & C,
+  Eigen::PlainObjectBase<Derivedcounts> & counts)
+{
+  const int n = P.size();
+  std::vector<int> R(n);
+#pragma omp parallel for if (n>IGL_OMP_MIN_VALUE)
+  for(int i = 0;i<n;i++)
+  {
+    R[i] = union_find_components_root(P,i);
+  }
+  C.resize(n,1);
+  int nc = 0;
+  for(int i = 0;i<n;i++)
+  {
+    // R[i] <= i so its label is already known
+    C(i) = R[i] == i ? nc++ : C(R[i]);
+  }
+  counts.setZero(nc,1);
+  for(int i = 0;i<n;i++)
+  {
+    counts(C(i))++;
+  }
+}
+
+template <typename DerivedG, typename DerivedC, typename Derivedcounts>
+IGL_INLINE void igl::union_find_components(
+  const int n,
+  const Eigen::PlainObjectBase<DerivedG> & G,
+  Eigen::PlainObjectBase<DerivedC> & C,
+  Eigen::PlainObjectBase<Derivedcounts> & counts)
+{
+  std::vector<std::atomic<int> > P(n);
+  for(int i = 0;i<n;i++)
+  {
+    P[i].store(i,std::memory_order_relaxed);
+  }
+  const int m = G.rows();
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int g = 0;g<m;g++)
+  {
+    int first = -1;
+    for(int c = 0;c<G.cols();c++)
+    {
+      const int i = G(g,c);
+      if(i < 0)
+      {
+        continue;
+      }
+      assert(i < n && "G should index 0:n-1");
+      if(first < 0)
+      {
+        first = i;
+      }else
+      {
+        union_find_components_unite(P,first,i);
+      }
+    }
+  }
+  union_find_components_label(P,C,counts);
+}
+
+template <typename AScalar, typename DerivedC, typename Derivedcounts>
+IGL_INLINE void igl::union_find_components(
+  const Eigen::SparseMatrix<AScalar> & A,
+  Eigen::PlainObjectBase<DerivedC> & C,
+  Eigen::PlainObjectBase<Derivedcounts> & counts)
+{
+  assert(A.rows() == A.cols() && "A should be square");
+  const int n = A.rows();
+  std::vector<std::atomic<int> > P(n);
+  for(int i = 0;i<n;i++)
+  {
+    P[i].store(i,std::memory_order_relaxed);
+  }
+  const int m = A.outerSize();
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int j = 0;j<m;j++)
+  {
+    for(typename Eigen::SparseMatrix<AScalar>::InnerIterator it(A,j);it;++it)
+    {
+      if(it.value() != 0)
+      {
+        union_find_components_unite(P,it.row(),it.col());
+      }
+    }
+  }
+  union_find_components_label(P,C,counts);
+}
+
+#ifdef IGL_STATIC_LIBRARY
+// Explicit template specialization
+template void igl::union_find_components<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+template void igl::union_find_components<Eigen::Matrix<long, -1, 2, 0, -1, 2>, Eigen::Matrix<long, -1, 1, 0, -1, 1>, Eigen::Matrix<long, -1, 1, 0, -1, 1> >(int, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 2, 0, -1, 2> > const&, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<long, -1, 1, 0, -1, 1> >&);
+template void igl::union_find_components<int, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::SparseMatrix<int, 0, int> const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
+#endif
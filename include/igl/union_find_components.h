@@ -0,0 +1,49 @@
+// This file is part of libigl, a simple c++ geometry processing library.
+//
+// Copyright (C) 2015 Alec Jacobson <alecjacobson@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public License
+// v. 2.0. If a copy of the MPL was not distributed with this file, You can
+// obtain one at http://mozilla.org/MPL/2.0/.
+#ifndef IGL_UNION_FIND_COMPONENTS_H
+#define IGL_UNION_FIND_COMPONENTS_H
+#include "igl_inline.h"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+namespace igl
+{
+  // UNION_FIND_COMPONENTS Compute connected components of n elements where
+  // each row of G lists elements that are connected to each other. Rows are
+  // merged concurrently into a lock-free union-find (no adjacency lists or
+  // graph are built), so this scales to very large inputs.
+  //
+  // Inputs:
+  //   n  number of elements
+  //   G  #G by k list of groups of indices into 0:n-1 (e.g. mesh faces F for
+  //     vertex components, or #E by 2 list of edges). Negative entries are
+  //     ignored.
+  // Outputs:
+  //   C  n list of component ids, numbered in order of the smallest index in
+  //     each component (as by a breadth first search from 0,1,...,n-1)
+  //   counts  #components list of number of elements in each component
+  //
+  template <typename DerivedG, typename DerivedC, typename Derivedcounts>
+  IGL_INLINE void union_find_components(
+    const int n,
+    const Eigen::PlainObjectBase<DerivedG> & G,
+    Eigen::PlainObjectBase<DerivedC> & C,
+    Eigen::PlainObjectBase<Derivedcounts> & counts);
+  // Inputs:
+  //   A  n by n adjacency matrix, i and j are connected if A(i,j) != 0
+  template <typename AScalar, typename DerivedC, typename Derivedcounts>
+  IGL_INLINE void union_find_components(
+    const Eigen::SparseMatrix<AScalar> & A,
+    Eigen::PlainObjectBase<DerivedC> & C,
+    Eigen::PlainObjectBase<Derivedcounts> & counts);
+}
+
+#ifndef IGL_STATIC_LIBRARY
+#  include "union_find_components.cpp"
+#endif
+
+#endif
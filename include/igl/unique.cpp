@@ -17,6 +17,15 @@
 #include <algorithm>
 #include <iostream>
 #include <map>
+#include <type_traits>
+
+#ifndef IGL_OMP_MIN_VALUE
+#  define IGL_OMP_MIN_VALUE 1000
+#endif
+// Integer matrices with more rows than this are unique'd by hashing
+#ifndef IGL_UNIQUE_ROWS_HASH_MIN_ROWS
+#  define IGL_UNIQUE_ROWS_HASH_MIN_ROWS 10000
+#endif
 
 template <typename T>
 IGL_INLINE void igl::unique(
@@ -200,6 +209,146 @@ IGL_INLINE void igl::unique(
 //   }
 // }
 
+// Hash based unique rows for integer matrices. Rows are partitioned by hash
+// and each partition is deduplicated with its own open addressing table in
+// parallel. Only the (fewer) unique rows are then sorted so that the output
+// matches the sort based version.
+template <typename DerivedA, typename DerivedIA, typename DerivedIC>
+static bool unique_rows_hash(
+  const Eigen::PlainObjectBase<DerivedA>& A,
+  Eigen::PlainObjectBase<DerivedA>& C,
+  Eigen::PlainObjectBase<DerivedIA>& IA,
+  Eigen::PlainObjectBase<DerivedIC>& IC,
+  std::true_type /*is_integral*/)
+{
+  using namespace std;
+  using namespace Eigen;
+  typedef unsigned long long Hash;
+  const int m = A.rows();
+  const int n = A.cols();
+  vector<Hash> H(m);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int i = 0;i<m;i++)
+  {
+    Hash h = 1469598103934665603ULL;
+    for(int j = 0;j<n;j++)
+    {
+      h = (h ^ (Hash)A(i,j)) * 1099511628211ULL;
+      h ^= h >> 29;
+    }
+    H[i] = h;
+  }
+  // Counting sort rows by partition (keeps increasing row order)
+  const int num_parts = 64;
+  vector<int> offset(num_parts+1,0);
+  for(int i = 0;i<m;i++)
+  {
+    offset[(H[i]>>58)+1]++;
+  }
+  for(int p = 0;p<num_parts;p++)
+  {
+    offset[p+1] += offset[p];
+  }
+  vector<int> R(m);
+  {
+    vector<int> next(offset.begin(),offset.end()-1);
+    for(int i = 0;i<m;i++)
+    {
+      R[next[H[i]>>58]++] = i;
+    }
+  }
+  // For each row, the first row with the same entries
+  vector<int> first(m);
+  vector<int> num_unique(num_parts+1,0);
+#pragma omp parallel for
+  for(int p = 0;p<num_parts;p++)
+  {
+    const int np = offset[p+1]-offset[p];
+    size_t cap = 16;
+    while(cap < 2*(size_t)np)
+    {
+      cap <<= 1;
+    }
+    vector<int> table(cap,-1);
+    int u = 0;
+    for(int k = offset[p];k<offset[p+1];k++)
+    {
+      const int i = R[k];
+      size_t s = H[i] & (cap-1);
+      while(true)
+      {
+        const int t = table[s];
+        if(t < 0)
+        {
+          table[s] = i;
+          first[i] = i;
+          u++;
+          break;
+        }
+        if(H[t] == H[i] && A.row(t) == A.row(i))
+        {
+          first[i] = t;
+          break;
+        }
+        s = (s+1) & (cap-1);
+      }
+    }
+    num_unique[p+1] = u;
+  }
+  for(int p = 0;p<num_parts;p++)
+  {
+    num_unique[p+1] += num_unique[p];
+  }
+  // Gather unique rows (first occurrences) and sort them
+  const int k = num_unique[num_parts];
+  vector<int> U;
+  U.reserve(k);
+  for(int i = 0;i<m;i++)
+  {
+    if(first[i] == i)
+    {
+      U.push_back(i);
+    }
+  }
+  DerivedA UA,sortUA;
+  UA.resize(k,n);
+#pragma omp parallel for if (k>IGL_OMP_MIN_VALUE)
+  for(int u = 0;u<k;u++)
+  {
+    UA.row(u) = A.row(U[u]);
+  }
+  VectorXi IM;
+  igl::sortrows(UA,true,sortUA,IM);
+  // rank of each unique (first occurrence) row
+  vector<int> rank(m);
+  IA.resize(k,1);
+  for(int u = 0;u<k;u++)
+  {
+    IA(u) = U[IM(u)];
+    rank[U[IM(u)]] = u;
+  }
+  C = sortUA;
+  IC.resize(m,1);
+#pragma omp parallel for if (m>IGL_OMP_MIN_VALUE)
+  for(int i = 0;i<m;i++)
+  {
+    IC(i) = rank[first[i]];
+  }
+  return true;
+}
+
+template <typename DerivedA, typename DerivedIA, typename DerivedIC>
+static bool unique_rows_hash(
+  const Eigen::PlainObjectBase<DerivedA>& /*A*/,
+  Eigen::PlainObjectBase<DerivedA>& /*C*/,
+  Eigen::PlainObjectBase<DerivedIA>& /*IA*/,
+  Eigen::PlainObjectBase<DerivedIC>& /*IC*/,
+  std::false_type /*is_integral*/)
+{
+  // Floating point rows (-0 vs 0, NaN) are left to the sort based version
+  return false;
+}
+
 template <typename DerivedA, typename DerivedIA, typename DerivedIC>
 IGL_INLINE void igl::unique_rows(
   const Eigen::PlainObjectBase<DerivedA>& A,
@@ -209,6 +358,13 @@ IGL_INLINE void igl::unique_rows(
 {
   using namespace std;
   using namespace Eigen;
+  if(A.rows() > IGL_UNIQUE_ROWS_HASH_MIN_ROWS &&
+    unique_rows_hash(A,C,IA,IC,
+      std::integral_constant<bool,
+        std::is_integral<typename DerivedA::Scalar>::value>()))
+  {
+    return;
+  }
   VectorXi IM;
   Eigen::PlainObjectBase<DerivedA> sortA;
   sortrows(A,true,sortA,IM);
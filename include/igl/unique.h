@@ -63,6 +63,9 @@ namespace igl
   //   C  #C vector of unique rows in A
   //   IA  #C index vector so that C = A(IA,:);
   //   IC  #A index vector so that A = C(IC,:);
+  //
+  // Note: Large integer matrices are unique'd by parallel hashing and only the
+  // unique rows are sorted; IA then refers to first occurrences.
   template <typename DerivedA, typename DerivedIA, typename DerivedIC>
   IGL_INLINE void unique_rows(
     const Eigen::PlainObjectBase<DerivedA>& A,
@@ -35,6 +35,27 @@ namespace igl
     Eigen::PlainObjectBase<DeriveduE> & uE,
     Eigen::PlainObjectBase<DerivedEMAP> & EMAP,
     std::vector<std::vector<uE2EType> > & uE2E);
+  // Compressed (CSR) version of uE2E
+  //
+  // Outputs:
+  //   uEC  #uE+1 list of offsets into uEE
+  //   uEE  #F*3 list of indices into E so that uEE(uEC(u)) ...
+  //     uEE(uEC(u+1)-1) are the coexisting directed edges of unique edge u
+  //     (in increasing order)
+  template <
+    typename DerivedF,
+    typename DerivedE,
+    typename DeriveduE,
+    typename DerivedEMAP,
+    typename DeriveduEC,
+    typename DeriveduEE>
+  IGL_INLINE void unique_edge_map(
+    const Eigen::PlainObjectBase<DerivedF> & F,
+    Eigen::PlainObjectBase<DerivedE> & E,
+    Eigen::PlainObjectBase<DeriveduE> & uE,
+    Eigen::PlainObjectBase<DerivedEMAP> & EMAP,
+    Eigen::PlainObjectBase<DeriveduEC> & uEC,
+    Eigen::PlainObjectBase<DeriveduEE> & uEE);
 
 }
 #ifndef IGL_STATIC_LIBRARY
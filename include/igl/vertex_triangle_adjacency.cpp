@@ -42,8 +42,50 @@ IGL_INLINE void igl::vertex_triangle_adjacency(
   return vertex_triangle_adjacency(V.rows(),F,VF,VFi);
 }
 
+template <
+  typename DerivedF,
+  typename DerivedVF,
+  typename DerivedVFi,
+  typename DerivedNI>
+IGL_INLINE void igl::vertex_triangle_adjacency(
+  const Eigen::PlainObjectBase<DerivedF>& F,
+  const int n,
+  Eigen::PlainObjectBase<DerivedVF>& VF,
+  Eigen::PlainObjectBase<DerivedVFi>& VFi,
+  Eigen::PlainObjectBase<DerivedNI>& NI)
+{
+  typedef typename DerivedF::Index Index;
+  // Count incidences per vertex and accumulate into offsets
+  NI.setZero(n+1,1);
+  for(Index fi=0; fi<F.rows(); ++fi)
+  {
+    for(Index i = 0; i < F.cols(); ++i)
+    {
+      NI(F(fi,i)+1)++;
+    }
+  }
+  for(int v = 0;v<n;v++)
+  {
+    NI(v+1) += NI(v);
+  }
+  // Scatter in face order so that each vertex's faces stay sorted
+  VF.resize(F.size(),1);
+  VFi.resize(F.size(),1);
+  std::vector<typename DerivedNI::Scalar> next(NI.data(),NI.data()+n);
+  for(Index fi=0; fi<F.rows(); ++fi)
+  {
+    for(Index i = 0; i < F.cols(); ++i)
+    {
+      const auto k = next[F(fi,i)]++;
+      VF(k) = fi;
+      VFi(k) = i;
+    }
+  }
+}
+
 #ifdef IGL_STATIC_LIBRARY
 // Explicit template specialization
+template void igl::vertex_triangle_adjacency<Eigen::Matrix<int, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1>, Eigen::Matrix<int, -1, 1, 0, -1, 1> >(Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, int, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, 1, 0, -1, 1> >&);
 // generated by autoexplicit.sh
 template void igl::vertex_triangle_adjacency<Eigen::Matrix<double, -1, -1, 0, -1, -1>, Eigen::Matrix<int, -1, -1, 0, -1, -1>, int>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, -1, 0, -1, -1> > const&, Eigen::PlainObjectBase<Eigen::Matrix<int, -1, -1, 0, -1, -1> > const&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >&, std::vector<std::vector<int, std::allocator<int> >, std::allocator<std::vector<int, std::allocator<int> > > >&);
 template void igl::vertex_triangle_adjacency<Eigen::Matrix<double, -1, 3, 1, -1, 3>, Eigen::Matrix<unsigned int, -1, -1, 1, -1, -1>, unsigned int>(Eigen::PlainObjectBase<Eigen::Matrix<double, -1, 3, 1, -1, 3> > const&, Eigen::PlainObjectBase<Eigen::Matrix<unsigned int, -1, -1, 1, -1, -1> > const&, std::vector<std::vector<unsigned int, std::allocator<unsigned int> >, std::allocator<std::vector<unsigned int, std::allocator<unsigned int> > > >&, std::vector<std::vector<unsigned int, std::allocator<unsigned int> >, std::allocator<std::vector<unsigned int, std::allocator<unsigned int> > > >&);
@@ -43,6 +43,29 @@ namespace igl
     const Eigen::PlainObjectBase<DerivedF>& F,
     std::vector<std::vector<IndexType> >& VF,
     std::vector<std::vector<IndexType> >& VFi);
+  // Compressed (CSR) version storing all incidences in flat arrays built by
+  // a counting sort, rather than one heap allocated list per vertex.
+  //
+  // Inputs:
+  //   F  #F by dim list of mesh faces
+  //   n  number of vertices #V (e.g. `F.maxCoeff()+1` or `V.rows()`)
+  // Outputs:
+  //   VF  #F*dim list of incident faces so that VF(NI(i)) ... VF(NI(i+1)-1)
+  //     are the faces incident on vertex i (in increasing order)
+  //   VFi  #F*dim list of index of incidence within incident faces listed in
+  //     VF
+  //   NI  #V+1 list of offsets into VF and VFi
+  template <
+    typename DerivedF,
+    typename DerivedVF,
+    typename DerivedVFi,
+    typename DerivedNI>
+  IGL_INLINE void vertex_triangle_adjacency(
+    const Eigen::PlainObjectBase<DerivedF>& F,
+    const int n,
+    Eigen::PlainObjectBase<DerivedVF>& VF,
+    Eigen::PlainObjectBase<DerivedVFi>& VFi,
+    Eigen::PlainObjectBase<DerivedNI>& NI);
 }
 
 #ifndef IGL_STATIC_LIBRARY
@@ -10,8 +10,7 @@
 
 #include <iostream>
 
-#include <igl/per_face_normals.h>
-#include <igl/per_vertex_normals.h>
+#include <igl/incremental_normals.h>
 
 #ifdef ENABLE_SERIALIZATION
 #include <igl/serialize.h>
@@ -352,12 +351,41 @@ IGL_INLINE void igl::ViewerData::clear()
   labels_strings.clear();
 
   face_based = false;
+
+  normals_cache = igl::incremental_normals_data();
 }
 
 IGL_INLINE void igl::ViewerData::compute_normals()
 {
-  igl::per_face_normals(V, F, F_normals);
-  igl::per_vertex_normals(V, F, F_normals, V_normals);
+  igl::incremental_normals_precompute(
+    V, F, igl::PER_VERTEX_NORMALS_WEIGHTING_TYPE_DEFAULT, normals_cache);
+  F_normals = normals_cache.FN;
+  V_normals = normals_cache.N;
+  dirty |= DIRTY_NORMAL;
+}
+
+IGL_INLINE void igl::ViewerData::compute_normals(const Eigen::VectorXi& I)
+{
+  if (normals_cache.N.rows() != V.rows() ||
+      normals_cache.F.rows() != F.rows() ||
+      normals_cache.F != F ||
+      F_normals.rows() != F.rows() ||
+      V_normals.rows() != V.rows())
+  {
+    compute_normals();
+    return;
+  }
+  Eigen::VectorXi R;
+  igl::incremental_normals_update(V, I, normals_cache, R);
+  // Copy back only the updated normals and the faces around them
+  for (int i = 0; i < R.size(); ++i)
+  {
+    const int v = R(i);
+    V_normals.row(v) = normals_cache.N.row(v);
+    for (int k = normals_cache.NI(v); k < normals_cache.NI(v+1); ++k)
+      F_normals.row(normals_cache.VF(k)) =
+        normals_cache.FN.row(normals_cache.VF(k));
+  }
   dirty |= DIRTY_NORMAL;
 }
 
@@ -15,6 +15,7 @@
 #include <Eigen/Core>
 
 #include <igl/igl_inline.h>
+#include <igl/incremental_normals.h>
 
 namespace igl
 {
@@ -89,6 +90,13 @@ public:
 
   // Computes the normals of the mesh
   IGL_INLINE void compute_normals();
+  // Updates the normals after only the vertices in I moved (e.g. while
+  // sculpting). Falls back to compute_normals() if the faces or the number of
+  // vertices changed since the last call.
+  //
+  // Inputs:
+  //   I  #I list of indices of moved vertices
+  IGL_INLINE void compute_normals(const Eigen::VectorXi& I);
 
   // Assigns uniform colors to all faces/vertices
   IGL_INLINE void uniform_colors(Eigen::Vector3d ambient, Eigen::Vector3d diffuse, Eigen::Vector3d specular);
@@ -145,6 +153,9 @@ public:
 
   // Enable per-face or per-vertex properties
   bool face_based;
+
+  // Cached incidences and weights used by compute_normals (not serialized)
+  igl::incremental_normals_data normals_cache;
   /*********************************/
 };
 